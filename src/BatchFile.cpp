@@ -0,0 +1,191 @@
+#include "BatchFile.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+    bool isBlank(std::string const& str) {
+        return std::all_of(str.begin(), str.end(), ::isspace);
+    }
+
+    std::string trim(std::string const& str) {
+        auto first = std::find_if_not(str.begin(), str.end(), ::isspace);
+        auto last = std::find_if_not(str.rbegin(), str.rend(), ::isspace).base();
+        return first < last ? std::string(first, last) : std::string();
+    }
+
+    void skipSpace(std::string const& line, size_t& position) {
+        while (position < line.size() && ::isspace(static_cast<unsigned char>(line[position]))) {
+            ++position;
+        }
+    }
+
+    void expect(std::string const& line, size_t& position, char c) {
+        skipSpace(line, position);
+        if (position >= line.size() || line[position] != c) {
+            throw std::invalid_argument(std::string("Expected '") + c + "' at position " + std::to_string(position) + " of the JSON object.");
+        }
+        ++position;
+    }
+
+    std::string parseJsonString(std::string const& line, size_t& position) {
+        expect(line, position, '"');
+        std::string res;
+        while (position < line.size() && line[position] != '"') {
+            char c = line[position++];
+            if (c != '\\') {
+                res += c;
+                continue;
+            }
+            if (position >= line.size()) {
+                break;
+            }
+            c = line[position++];
+            switch (c) {
+                case 'n':
+                    res += '\n';
+                    break;
+                case 't':
+                    res += '\t';
+                    break;
+                case 'r':
+                    res += '\r';
+                    break;
+                case 'b':
+                    res += '\b';
+                    break;
+                case 'f':
+                    res += '\f';
+                    break;
+                case 'u': {
+                    //! Regions and options are ASCII, so only code points below 128 are supported
+                    unsigned long code = position + 4 <= line.size() ? std::stoul(line.substr(position, 4), nullptr, 16) : 128;
+                    if (code >= 128) {
+                        throw std::invalid_argument("Only ASCII characters are supported in the JSON object.");
+                    }
+                    res += static_cast<char>(code);
+                    position += 4;
+                    break;
+                }
+                default:
+                    res += c;
+            }
+        }
+        expect(line, position, '"');
+        return res;
+    }
+}
+
+std::vector<std::string> parseCsvLine(std::string const& line) {
+    std::vector<std::string> res(1);
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); ++i) {
+        char c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                res.back() += '"';
+                ++i;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                res.back() += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            res.emplace_back();
+        } else if (c != '\r') {
+            res.back() += c;
+        }
+    }
+    if (quoted) {
+        throw std::invalid_argument("A quoted field is not closed.");
+    }
+    return res;
+}
+
+std::vector<std::pair<std::string, std::string>> parseJsonObject(std::string const& line) {
+    std::vector<std::pair<std::string, std::string>> res;
+    size_t position = 0;
+    expect(line, position, '{');
+    skipSpace(line, position);
+    if (position < line.size() && line[position] == '}') {
+        return res;
+    }
+    while (true) {
+        std::string key = parseJsonString(line, position);
+        expect(line, position, ':');
+        skipSpace(line, position);
+        if (position < line.size() && line[position] == '"') {
+            res.emplace_back(key, parseJsonString(line, position));
+        } else {
+            size_t end = line.find_first_of(",}", position);
+            if (end == std::string::npos) {
+                throw std::invalid_argument("The JSON object is not closed.");
+            }
+            res.emplace_back(key, trim(line.substr(position, end - position)));
+            position = end;
+        }
+        skipSpace(line, position);
+        if (position < line.size() && line[position] == ',') {
+            ++position;
+            continue;
+        }
+        expect(line, position, '}');
+        return res;
+    }
+}
+
+std::vector<BatchRow> readBatchFile(std::string const& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::invalid_argument(path + " is not a valid path/file.");
+    }
+    bool const json = path.size() >= 6 && path.compare(path.size() - 6, 6, ".jsonl") == 0;
+
+    std::vector<BatchRow> res;
+    std::string line;
+    bool first = true;
+    while (std::getline(file, line)) {
+        if (isBlank(line)) {
+            continue;
+        }
+        BatchRow row;
+        try {
+            if (json) {
+                for (auto const& entry : parseJsonObject(line)) {
+                    if (entry.first == "region") {
+                        row.region = entry.second;
+                    } else if (entry.first == "epsilon") {
+                        row.epsilon = entry.second;
+                    } else if (entry.first == "options") {
+                        row.options = entry.second;
+                    } else {
+                        throw std::invalid_argument("Unknown key " + entry.first + ", use region, epsilon and options.");
+                    }
+                }
+            } else {
+                std::vector<std::string> fields = parseCsvLine(line);
+                if (first && trim(fields[0]) == "region") {
+                    first = false;
+                    continue;
+                }
+                if (fields.size() > 3) {
+                    throw std::invalid_argument("A row has at most the columns region, epsilon and options, quote the region.");
+                }
+                row.region = fields[0];
+                row.epsilon = fields.size() > 1 ? trim(fields[1]) : "";
+                row.options = fields.size() > 2 ? fields[2] : "";
+            }
+            if (row.region.empty() || row.epsilon.empty()) {
+                throw std::invalid_argument("The region and epsilon are obligatory.");
+            }
+        } catch (std::exception const& e) {
+            row.error = e.what();
+        }
+        first = false;
+        res.push_back(row);
+    }
+    return res;
+}
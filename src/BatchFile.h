@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/*!
+ * A query of a batch file: the initial instantiation in form of a region, epsilon and the options of the query.
+ * If the row cannot be parsed, error is set and the row is answered with an error record.
+ */
+struct BatchRow {
+    std::string region;
+    std::string epsilon;
+    std::string options;
+    std::string error;
+};
+
+/*!
+ * Splits a line of a CSV file into its fields. Fields can be quoted with '"', a quote in a quoted field is written as "".
+ *
+ * @param line - The line.
+ *
+ * @return The fields.
+ */
+std::vector<std::string> parseCsvLine(std::string const& line);
+
+/*!
+ * Parses a flat JSON object, whose values are strings or numbers, e.g. {"region": "0.5<=p<=0.5", "epsilon": 0.1}.
+ * Numbers are returned as written.
+ *
+ * @param line - The object.
+ *
+ * @return The keys and values, in the order of the object.
+ */
+std::vector<std::pair<std::string, std::string>> parseJsonObject(std::string const& line);
+
+/*!
+ * Reads the queries of a batch file. A file ending in .jsonl has a JSON object with the keys "region", "epsilon" and
+ * optionally "options" on every line. Any other file is read as CSV with the columns region, epsilon and optionally
+ * options, a first line starting with the column name region is skipped. Empty lines are skipped.
+ *
+ * @param path - The path to the batch file.
+ *
+ * @return The rows in the order of the file.
+ */
+std::vector<BatchRow> readBatchFile(std::string const& path);
@@ -0,0 +1,317 @@
+#include "BinaryModelCache.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <storm/api/storm.h>
+#include <storm-parsers/api/storm-parsers.h>
+#include <storm-parsers/parser/ValueParser.h>
+#include <storm/storage/SparseMatrix.h>
+#include <storm/storage/BitVector.h>
+#include <storm/models/sparse/StateLabeling.h>
+#include <storm/utility/macros.h>
+#include <storm/exceptions/FileIoException.h>
+
+#include "DrnParser.h"
+#include "MappedFile.h"
+
+namespace {
+    char const MAGIC[8] = {'M', 'C', 'P', 'P', 'M', 'C', '0', '1'};
+
+    struct Header {
+        char magic[8];
+        uint64_t checksum;
+        uint64_t numberOfStates;
+        uint64_t numberOfEntries;
+        uint64_t numberOfParameters;
+        uint64_t numberOfFunctions;
+        uint64_t numberOfLabels;
+    };
+
+    /*!
+     * Appends values to a buffer. Arrays are aligned to 8 bytes, so they can be used directly from the mapped file.
+     */
+    class Writer {
+    public:
+        template<typename T>
+        void write(T const& value) {
+            buffer.append(reinterpret_cast<char const*>(&value), sizeof(T));
+        }
+
+        template<typename T>
+        void writeArray(std::vector<T> const& values) {
+            align();
+            buffer.append(reinterpret_cast<char const*>(values.data()), values.size() * sizeof(T));
+        }
+
+        void writeString(std::string const& str) {
+            write<uint32_t>(static_cast<uint32_t>(str.size()));
+            buffer.append(str);
+        }
+
+        void align() {
+            while (buffer.size() % 8 != 0) {
+                buffer.push_back('\0');
+            }
+        }
+
+        std::string const& getBuffer() const {
+            return buffer;
+        }
+
+    private:
+        std::string buffer;
+    };
+
+    /*!
+     * Reads values written by Writer, every read is checked against the size of the data.
+     */
+    class Reader {
+    public:
+        Reader(char const* data, size_t size) : data(data), size(size), position(0) {
+        }
+
+        template<typename T>
+        T read() {
+            check(sizeof(T));
+            T value;
+            std::memcpy(&value, data + position, sizeof(T));
+            position += sizeof(T);
+            return value;
+        }
+
+        template<typename T>
+        T const* readArray(uint64_t count) {
+            align();
+            if (count > size / sizeof(T)) {
+                throw std::runtime_error("The binary model is truncated.");
+            }
+            check(count * sizeof(T));
+            T const* res = reinterpret_cast<T const*>(data + position);
+            position += count * sizeof(T);
+            return res;
+        }
+
+        std::string readString() {
+            uint32_t length = read<uint32_t>();
+            check(length);
+            std::string res(data + position, length);
+            position += length;
+            return res;
+        }
+
+        void align() {
+            position = (position + 7) / 8 * 8;
+        }
+
+    private:
+        void check(uint64_t bytes) const {
+            if (position > size || bytes > size - position) {
+                throw std::runtime_error("The binary model is truncated.");
+            }
+        }
+
+        char const* data;
+        size_t size;
+        size_t position;
+    };
+}
+
+uint64_t fileChecksum(std::string const& path) {
+    std::ifstream file(path, std::ios::binary);
+    STORM_LOG_THROW(file, storm::exceptions::FileIoException, "Could not open " << path);
+    uint64_t hash = 14695981039346656037ull;
+    std::vector<char> chunk(1 << 16);
+    while (file) {
+        file.read(chunk.data(), chunk.size());
+        std::streamsize n = file.gcount();
+        for (std::streamsize i = 0; i < n; ++i) {
+            hash ^= static_cast<unsigned char>(chunk[i]);
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+void writeBinaryModel(std::string const& cachePath, storm::models::sparse::Dtmc<storm::RationalFunction> const& model, uint64_t checksum) {
+    auto const& matrix = model.getTransitionMatrix();
+
+    //!Every distinct transition function is stored once
+    std::map<std::string, uint32_t> interned;
+    std::vector<std::string> functions;
+    std::vector<uint64_t> rowStarts = {0};
+    std::vector<uint64_t> columns;
+    std::vector<uint32_t> values;
+    columns.reserve(matrix.getEntryCount());
+    values.reserve(matrix.getEntryCount());
+    for (uint64_t state = 0; state < model.getNumberOfStates(); ++state) {
+        for (auto const& entry : matrix.getRow(state)) {
+            std::ostringstream function;
+            function << entry.getValue();
+            auto it = interned.find(function.str());
+            if (it == interned.end()) {
+                it = interned.emplace(function.str(), static_cast<uint32_t>(functions.size())).first;
+                functions.push_back(function.str());
+            }
+            columns.push_back(entry.getColumn());
+            values.push_back(it->second);
+        }
+        rowStarts.push_back(columns.size());
+    }
+
+    auto parameters = storm::models::sparse::getProbabilityParameters(model);
+    auto labels = model.getStateLabeling().getLabels();
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.checksum = checksum;
+    header.numberOfStates = model.getNumberOfStates();
+    header.numberOfEntries = columns.size();
+    header.numberOfParameters = parameters.size();
+    header.numberOfFunctions = functions.size();
+    header.numberOfLabels = labels.size();
+
+    Writer writer;
+    writer.write(header);
+    writer.writeArray(rowStarts);
+    writer.writeArray(columns);
+    writer.writeArray(values);
+    for (auto const& parameter : parameters) {
+        writer.writeString(parameter.name());
+    }
+    for (auto const& function : functions) {
+        writer.writeString(function);
+    }
+    for (auto const& label : labels) {
+        writer.writeString(label);
+        std::vector<uint64_t> states;
+        for (auto const& state : model.getStateLabeling().getStates(label)) {
+            states.push_back(state);
+        }
+        writer.align();
+        writer.write<uint64_t>(states.size());
+        writer.writeArray(states);
+    }
+
+    //!Every writer has its own temporary file, so concurrent runs cannot write into the same file
+    std::vector<char> temporaryName(cachePath.begin(), cachePath.end());
+    std::string const suffix = ".XXXXXX";
+    temporaryName.insert(temporaryName.end(), suffix.begin(), suffix.end());
+    temporaryName.push_back('\0');
+    int fd = mkstemp(temporaryName.data());
+    STORM_LOG_THROW(fd >= 0, storm::exceptions::FileIoException, "Could not create a temporary file for " << cachePath);
+    //!mkstemp creates the file only readable by the owner
+    fchmod(fd, 0644);
+    close(fd);
+    std::string temporaryPath(temporaryName.data());
+    bool written;
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(writer.getBuffer().data(), writer.getBuffer().size());
+        written = static_cast<bool>(file);
+    }
+    if (!written || std::rename(temporaryPath.c_str(), cachePath.c_str()) != 0) {
+        std::remove(temporaryPath.c_str());
+        STORM_LOG_THROW(false, storm::exceptions::FileIoException, "Could not write " << temporaryPath);
+    }
+}
+
+std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> readBinaryModel(std::string const& cachePath, uint64_t checksum) {
+    MappedFile file(cachePath);
+    if (!file.valid()) {
+        return nullptr;
+    }
+    try {
+        Reader reader(file.getData(), file.getSize());
+        Header header = reader.read<Header>();
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.checksum != checksum) {
+            return nullptr;
+        }
+        uint64_t const numberOfStates = header.numberOfStates;
+        uint64_t const* rowStarts = reader.readArray<uint64_t>(numberOfStates + 1);
+        uint64_t const* columns = reader.readArray<uint64_t>(header.numberOfEntries);
+        uint32_t const* values = reader.readArray<uint32_t>(header.numberOfEntries);
+
+        //!Only the distinct transition functions are parsed
+        storm::parser::ValueParser<storm::RationalFunction> valueParser;
+        for (uint64_t i = 0; i < header.numberOfParameters; ++i) {
+            valueParser.addParameter(reader.readString());
+        }
+        std::vector<storm::RationalFunction> functions;
+        functions.reserve(header.numberOfFunctions);
+        for (uint64_t i = 0; i < header.numberOfFunctions; ++i) {
+            functions.push_back(valueParser.parseValue(reader.readString()));
+        }
+
+        storm::storage::SparseMatrixBuilder<storm::RationalFunction> builder(numberOfStates, numberOfStates, header.numberOfEntries, true, false);
+        for (uint64_t state = 0; state < numberOfStates; ++state) {
+            if (rowStarts[state] > rowStarts[state + 1] || rowStarts[state + 1] > header.numberOfEntries) {
+                return nullptr;
+            }
+            for (uint64_t entry = rowStarts[state]; entry < rowStarts[state + 1]; ++entry) {
+                if (columns[entry] >= numberOfStates || values[entry] >= functions.size()) {
+                    return nullptr;
+                }
+                builder.addNextValue(state, columns[entry], functions[values[entry]]);
+            }
+        }
+
+        storm::models::sparse::StateLabeling labeling(numberOfStates);
+        for (uint64_t i = 0; i < header.numberOfLabels; ++i) {
+            std::string label = reader.readString();
+            reader.align();
+            uint64_t count = reader.read<uint64_t>();
+            uint64_t const* states = reader.readArray<uint64_t>(count);
+            storm::storage::BitVector labeled(numberOfStates);
+            for (uint64_t j = 0; j < count; ++j) {
+                if (states[j] >= numberOfStates) {
+                    return nullptr;
+                }
+                labeled.set(states[j]);
+            }
+            labeling.addLabel(label, labeled);
+        }
+
+        return std::make_shared<storm::models::sparse::Dtmc<storm::RationalFunction>>(builder.build(), labeling);
+    } catch (std::exception const&) {
+        //!Also the exceptions of storm, e.g. if a function in a corrupt file cannot be parsed, then the cache is rebuilt
+        return nullptr;
+    }
+}
+
+std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> buildModelWithBinaryCache(std::string const& path_to_model, size_t parseThreads) {
+    uint64_t checksum = fileChecksum(path_to_model);
+    std::string cachePath = path_to_model + ".pmc";
+
+    auto model = readBinaryModel(cachePath, checksum);
+    if (model) {
+        std::cout << "Loaded the model from the binary cache " << cachePath << std::endl;
+        return model;
+    }
+
+    if (parseThreads > 0) {
+        model = parseDrnModel(path_to_model, parseThreads);
+    }
+    if (!model) {
+        model = storm::api::buildExplicitDRNModel<storm::RationalFunction>(path_to_model)->template as<storm::models::sparse::Dtmc<storm::RationalFunction>>();
+    }
+    if (!model->hasRewardModel()) {
+        try {
+            writeBinaryModel(cachePath, *model, checksum);
+            std::cout << "Wrote the binary cache " << cachePath << std::endl;
+        } catch (storm::exceptions::BaseException const& e) {
+            std::cout << "Could not write the binary cache: " << e.what() << std::endl;
+        }
+    }
+    return model;
+}
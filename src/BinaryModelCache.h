@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <storm/adapters/RationalFunctionAdapter.h>
+#include <storm/models/sparse/Dtmc.h>
+
+/*!
+ * A binary cache of parsed parametric DTMCs. The file holds the transition matrix in CSR layout, where every entry
+ * refers to an interned transition function, the parameters, the labels and a checksum of the source file.
+ * Only the distinct transition functions have to be parsed when the cache is loaded, the rest is read directly from the
+ * memory mapped file. Reward models are not stored.
+ */
+
+/*!
+ * Computes a checksum (FNV-1a) of a file.
+ *
+ * @param path - The path to the file.
+ *
+ * @return The checksum.
+ */
+uint64_t fileChecksum(std::string const& path);
+
+/*!
+ * Writes the model to a binary cache file. The file is first written to a temporary file and then renamed, so that
+ * concurrent readers never see a partial file.
+ *
+ * @param cachePath - The path to the cache file.
+ * @param model - The model.
+ * @param checksum - The checksum of the source file.
+ */
+void writeBinaryModel(std::string const& cachePath, storm::models::sparse::Dtmc<storm::RationalFunction> const& model, uint64_t checksum);
+
+/*!
+ * Reads the model from a binary cache file.
+ *
+ * @param cachePath - The path to the cache file.
+ * @param checksum - The checksum of the source file.
+ *
+ * @return The model or nullptr, if the file is missing, invalid or was built from a different source.
+ */
+std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> readBinaryModel(std::string const& cachePath, uint64_t checksum);
+
+/*!
+ * Builds the model from a drn file, using the binary cache next to it (path_to_model + ".pmc").
+ * The cache is rebuilt, if it does not exist or the drn file changed.
+ *
+ * @param path_to_model - The path to the drn file.
+ * @param parseThreads - If positive, the drn file is parsed with parseDrnModel on that many threads.
+ *
+ * @return The model.
+ */
+std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> buildModelWithBinaryCache(std::string const& path_to_model, size_t parseThreads = 0);
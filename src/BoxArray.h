@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "Metric.h"
+
+/*!
+ * Axis-parallel boxes stored as structure of arrays: for every dimension there is one contiguous array of the lower
+ * and one of the upper bounds of all boxes, so the distance of a point to all boxes is computed in vectorizable loops.
+ * Distances are measured in a Metric, the closest point of a box is the projection onto it for every Metric.
+ */
+class BoxArray {
+public:
+    /*!
+     * @param dimension - The number of parameters of every box.
+     */
+    explicit BoxArray(size_t dimension) : dimension(dimension), count(0), lowerBounds(dimension), upperBounds(dimension) {
+    }
+
+    void reserve(size_t numberOfBoxes) {
+        for (size_t d = 0; d < dimension; ++d) {
+            lowerBounds[d].reserve(numberOfBoxes);
+            upperBounds[d].reserve(numberOfBoxes);
+        }
+    }
+
+    /*!
+     * Appends a box.
+     *
+     * @param lower - The lower bound for every dimension.
+     * @param upper - The upper bound for every dimension.
+     *
+     * @return The index of the box.
+     */
+    size_t add(std::vector<double> const& lower, std::vector<double> const& upper) {
+        for (size_t d = 0; d < dimension; ++d) {
+            lowerBounds[d].push_back(lower[d]);
+            upperBounds[d].push_back(upper[d]);
+        }
+        return count++;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    size_t getDimension() const {
+        return dimension;
+    }
+
+    double lower(size_t box, size_t d) const {
+        return lowerBounds[d][box];
+    }
+
+    double upper(size_t box, size_t d) const {
+        return upperBounds[d][box];
+    }
+
+    /*!
+     * Computes the distance of the point to every box, i.e. to the projection of the point onto the box.
+     * The norm is chosen once outside of the loops, so the inner loop over all boxes has no branches.
+     *
+     * @param point - The point, one value per dimension.
+     * @param metric - The metric.
+     * @param result - Is resized and filled with one distance per box.
+     */
+    void distances(std::vector<double> const& point, Metric const& metric, std::vector<double>& result) const {
+        result.assign(count, 0.0);
+        double* res = result.data();
+        for (size_t d = 0; d < dimension; ++d) {
+            double const x = point[d];
+            double const w = metric.weight(d);
+            double const* lo = lowerBounds[d].data();
+            double const* hi = upperBounds[d].data();
+            switch (metric.getNorm()) {
+                case Metric::Norm::L1:
+                    for (size_t i = 0; i < count; ++i) {
+                        res[i] += w * std::abs(std::min(std::max(x, lo[i]), hi[i]) - x);
+                    }
+                    break;
+                case Metric::Norm::L2:
+                    for (size_t i = 0; i < count; ++i) {
+                        double const diff = w * (std::min(std::max(x, lo[i]), hi[i]) - x);
+                        res[i] += diff * diff;
+                    }
+                    break;
+                default:
+                    for (size_t i = 0; i < count; ++i) {
+                        res[i] = std::max(res[i], w * std::abs(std::min(std::max(x, lo[i]), hi[i]) - x));
+                    }
+                    break;
+            }
+        }
+        if (metric.getNorm() == Metric::Norm::L2) {
+            for (size_t i = 0; i < count; ++i) {
+                res[i] = std::sqrt(res[i]);
+            }
+        }
+    }
+
+    /*!
+     * Projects the point onto a box, which gives the point of the box closest to it.
+     *
+     * @param box - The index of the box.
+     * @param point - The point, one value per dimension.
+     *
+     * @return The closest point of the box.
+     */
+    std::vector<double> project(size_t box, std::vector<double> const& point) const {
+        std::vector<double> res(dimension);
+        for (size_t d = 0; d < dimension; ++d) {
+            res[d] = std::min(std::max(point[d], lowerBounds[d][box]), upperBounds[d][box]);
+        }
+        return res;
+    }
+
+    /*!
+     * Finds the box closest to the point by checking all boxes.
+     *
+     * @param point - The point, one value per dimension.
+     * @param metric - The metric.
+     * @param distance - Set to the distance of the closest box.
+     *
+     * @return The index of the closest box or size(), if there are no boxes.
+     */
+    size_t closest(std::vector<double> const& point, Metric const& metric, double& distance) const {
+        std::vector<double> result;
+        distances(point, metric, result);
+        size_t res = count;
+        distance = std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < count; ++i) {
+            if (result[i] < distance) {
+                distance = result[i];
+                res = i;
+            }
+        }
+        return res;
+    }
+
+private:
+    size_t dimension;
+    size_t count;
+    std::vector<std::vector<double>> lowerBounds;
+    std::vector<std::vector<double>> upperBounds;
+};
+
+/*!
+ * A bounding volume hierarchy over the boxes of a BoxArray, to find the boxes overlapping a box without looking at all
+ * boxes. Building it costs more than a single search over all boxes, so it pays off when the same boxes are searched
+ * repeatedly. The BoxArray must not change while the index is used.
+ */
+class BoxIndex {
+public:
+    /*!
+     * @param boxes - The boxes to index.
+     * @param leafSize - The maximal number of boxes in a leaf.
+     */
+    explicit BoxIndex(BoxArray const& boxes, size_t leafSize = 32) : boxes(boxes), leafSize(leafSize == 0 ? 1 : leafSize) {
+        order.resize(boxes.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        if (!order.empty()) {
+            build(0, order.size());
+        }
+    }
+
+    /*!
+     * Finds the boxes that overlap the given box in a set of positive volume, boxes that only touch it are left out.
+     *
+     * @param lower - The lower bound for every dimension.
+     * @param upper - The upper bound for every dimension.
+     * @param result - The indices of the overlapping boxes are appended.
+     */
+    void overlapping(std::vector<double> const& lower, std::vector<double> const& upper, std::vector<size_t>& result) const {
+        if (nodes.empty()) {
+            return;
+        }
+        std::vector<size_t> stack(1, 0);
+        while (!stack.empty()) {
+            Node const& node = nodes[stack.back()];
+            stack.pop_back();
+            if (!overlaps(node.lower, node.upper, lower, upper)) {
+                continue;
+            }
+            if (node.left == NONE) {
+                for (size_t i = node.begin; i < node.end; ++i) {
+                    bool overlap = true;
+                    for (size_t d = 0; d < lower.size() && overlap; ++d) {
+                        overlap = boxes.lower(order[i], d) < upper[d] && lower[d] < boxes.upper(order[i], d);
+                    }
+                    if (overlap) {
+                        result.push_back(order[i]);
+                    }
+                }
+            } else {
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+    }
+
+private:
+    static const size_t NONE = std::numeric_limits<size_t>::max();
+
+    static bool overlaps(std::vector<double> const& lowerA, std::vector<double> const& upperA, std::vector<double> const& lowerB, std::vector<double> const& upperB) {
+        for (size_t d = 0; d < lowerA.size(); ++d) {
+            if (upperA[d] <= lowerB[d] || upperB[d] <= lowerA[d]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    struct Node {
+        std::vector<double> lower;
+        std::vector<double> upper;
+        size_t begin;
+        size_t end;
+        size_t left;
+        size_t right;
+    };
+
+    size_t build(size_t begin, size_t end) {
+        size_t const dimension = boxes.getDimension();
+        Node node;
+        node.lower.assign(dimension, std::numeric_limits<double>::infinity());
+        node.upper.assign(dimension, -std::numeric_limits<double>::infinity());
+        node.begin = begin;
+        node.end = end;
+        node.left = NONE;
+        node.right = NONE;
+        for (size_t i = begin; i < end; ++i) {
+            for (size_t d = 0; d < dimension; ++d) {
+                node.lower[d] = std::min(node.lower[d], boxes.lower(order[i], d));
+                node.upper[d] = std::max(node.upper[d], boxes.upper(order[i], d));
+            }
+        }
+        size_t index = nodes.size();
+        nodes.push_back(node);
+        if (end - begin <= leafSize) {
+            return index;
+        }
+
+        //!Split at the median of the box centers along the longest side
+        size_t axis = 0;
+        for (size_t d = 1; d < dimension; ++d) {
+            if (node.upper[d] - node.lower[d] > node.upper[axis] - node.lower[axis]) {
+                axis = d;
+            }
+        }
+        size_t middle = begin + (end - begin) / 2;
+        std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end, [this, axis](size_t a, size_t b) {
+            return boxes.lower(a, axis) + boxes.upper(a, axis) < boxes.lower(b, axis) + boxes.upper(b, axis);
+        });
+        size_t left = build(begin, middle);
+        size_t right = build(middle, end);
+        nodes[index].left = left;
+        nodes[index].right = right;
+        return index;
+    }
+
+    BoxArray const& boxes;
+    size_t leafSize;
+    std::vector<size_t> order;
+    std::vector<Node> nodes;
+};
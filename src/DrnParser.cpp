@@ -0,0 +1,341 @@
+#include "DrnParser.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <storm-parsers/parser/ValueParser.h>
+#include <storm/storage/SparseMatrix.h>
+#include <storm/storage/BitVector.h>
+#include <storm/models/sparse/StateLabeling.h>
+#include <storm/utility/macros.h>
+#include <storm/exceptions/FileIoException.h>
+#include <storm/exceptions/WrongFormatException.h>
+
+#include "MappedFile.h"
+
+namespace {
+    /*!
+     * A line of the mapped file without the line break.
+     */
+    struct Line {
+        char const* begin;
+        char const* end;
+    };
+
+    bool readLine(char const* data, size_t end, size_t& position, Line& line) {
+        if (position >= end) {
+            return false;
+        }
+        char const* begin = data + position;
+        char const* newline = static_cast<char const*>(std::memchr(begin, '\n', end - position));
+        char const* lineEnd = newline == nullptr ? data + end : newline;
+        position = newline == nullptr ? end : static_cast<size_t>(newline - data) + 1;
+        if (lineEnd > begin && lineEnd[-1] == '\r') {
+            --lineEnd;
+        }
+        line = Line{begin, lineEnd};
+        return true;
+    }
+
+    Line trim(Line line) {
+        while (line.begin < line.end && ::isspace(static_cast<unsigned char>(*line.begin))) {
+            ++line.begin;
+        }
+        while (line.end > line.begin && ::isspace(static_cast<unsigned char>(line.end[-1]))) {
+            --line.end;
+        }
+        return line;
+    }
+
+    bool startsWith(Line const& line, char const* prefix) {
+        size_t length = std::strlen(prefix);
+        return static_cast<size_t>(line.end - line.begin) >= length && std::memcmp(line.begin, prefix, length) == 0;
+    }
+
+    std::string toString(Line const& line) {
+        return std::string(line.begin, line.end);
+    }
+
+    /*!
+     * Parses a non-negative integer, the mapped file is not null-terminated, so strtoull cannot be used.
+     *
+     * @return false, if there is no digit at position.
+     */
+    bool parseNumber(char const*& position, char const* end, uint64_t& value) {
+        char const* start = position;
+        value = 0;
+        while (position < end && *position >= '0' && *position <= '9') {
+            value = value * 10 + static_cast<uint64_t>(*position - '0');
+            ++position;
+        }
+        return position != start;
+    }
+
+    struct DrnHeader {
+        //! false if the file uses a feature that is left to the parser of storm
+        bool supported = true;
+        std::vector<std::string> parameters;
+        uint64_t numberOfStates = 0;
+        //! The offset of the first line after @model
+        size_t modelStart = 0;
+    };
+
+    DrnHeader parseHeader(char const* data, size_t size) {
+        DrnHeader res;
+        bool hasNumberOfStates = false;
+        size_t position = 0;
+        Line line;
+        while (readLine(data, size, position, line)) {
+            Line trimmed = trim(line);
+            if (trimmed.begin == trimmed.end || startsWith(trimmed, "//")) {
+                continue;
+            }
+            if (startsWith(trimmed, "@model")) {
+                STORM_LOG_THROW(hasNumberOfStates, storm::exceptions::WrongFormatException, "The drn file has no @nr_states section.");
+                res.modelStart = position;
+                return res;
+            } else if (startsWith(trimmed, "@type")) {
+                char const* colon = static_cast<char const*>(std::memchr(trimmed.begin, ':', trimmed.end - trimmed.begin));
+                res.supported = res.supported && colon != nullptr && toString(trim(Line{colon + 1, trimmed.end})) == "DTMC";
+            } else if (startsWith(trimmed, "@value_type")) {
+                continue;
+            } else if (startsWith(trimmed, "@parameters") || startsWith(trimmed, "@reward_models") || startsWith(trimmed, "@nr_states") || startsWith(trimmed, "@nr_choices")) {
+                //! The values are on the next line
+                Line values{trimmed.end, trimmed.end};
+                if (readLine(data, size, position, values)) {
+                    values = trim(values);
+                }
+                if (startsWith(trimmed, "@parameters")) {
+                    std::string names = toString(values);
+                    std::istringstream stream(names);
+                    std::string name;
+                    while (stream >> name) {
+                        res.parameters.push_back(name);
+                    }
+                } else if (startsWith(trimmed, "@reward_models")) {
+                    res.supported = res.supported && values.begin == values.end;
+                } else if (startsWith(trimmed, "@nr_states")) {
+                    char const* number = values.begin;
+                    STORM_LOG_THROW(parseNumber(number, values.end, res.numberOfStates), storm::exceptions::WrongFormatException, "Expected the number of states after @nr_states.");
+                    hasNumberOfStates = true;
+                }
+            } else {
+                res.supported = false;
+            }
+        }
+        STORM_LOG_THROW(false, storm::exceptions::WrongFormatException, "The drn file has no @model section.");
+    }
+
+    /*!
+     * The states of a chunk of the file. The transitions are stored row by row, sorted by the target state, and refer to
+     * the distinct functions of the chunk.
+     */
+    struct Chunk {
+        std::vector<uint64_t> states;
+        std::vector<uint64_t> rowStarts = {0};
+        std::vector<uint64_t> columns;
+        std::vector<uint32_t> values;
+        std::vector<std::string> functions;
+        std::vector<std::pair<std::string, uint64_t>> labels;
+        std::string error;
+    };
+
+    void scanChunk(char const* data, size_t begin, size_t end, uint64_t numberOfStates, Chunk& chunk) {
+        std::unordered_map<std::string, uint32_t> interned;
+        std::vector<std::pair<uint64_t, uint32_t>> row;
+        bool hasAction = false;
+        auto finishRow = [&]() {
+            std::sort(row.begin(), row.end());
+            for (size_t i = 0; i < row.size(); ++i) {
+                STORM_LOG_THROW(i == 0 || row[i].first != row[i - 1].first, storm::exceptions::WrongFormatException,
+                                "The state " << chunk.states.back() << " has two transitions to " << row[i].first << ".");
+                chunk.columns.push_back(row[i].first);
+                chunk.values.push_back(row[i].second);
+            }
+            chunk.rowStarts.push_back(chunk.columns.size());
+            row.clear();
+        };
+
+        size_t position = begin;
+        Line line;
+        while (readLine(data, end, position, line)) {
+            Line trimmed = trim(line);
+            if (trimmed.begin == trimmed.end) {
+                continue;
+            }
+            if (startsWith(trimmed, "state ")) {
+                if (!chunk.states.empty()) {
+                    finishRow();
+                }
+                char const* current = trimmed.begin + 6;
+                uint64_t state;
+                STORM_LOG_THROW(parseNumber(current, trimmed.end, state), storm::exceptions::WrongFormatException, "Expected a state number in " << toString(trimmed));
+                chunk.states.push_back(state);
+                hasAction = false;
+
+                //! Rewards in brackets are skipped, the labels are separated by spaces and can be quoted
+                while (current < trimmed.end) {
+                    while (current < trimmed.end && ::isspace(static_cast<unsigned char>(*current))) {
+                        ++current;
+                    }
+                    if (current == trimmed.end) {
+                        break;
+                    }
+                    char const* tokenEnd;
+                    if (*current == '[') {
+                        tokenEnd = std::find(current, trimmed.end, ']');
+                        current = tokenEnd == trimmed.end ? tokenEnd : tokenEnd + 1;
+                        continue;
+                    }
+                    if (*current == '"') {
+                        tokenEnd = std::find(current + 1, trimmed.end, '"');
+                        chunk.labels.emplace_back(std::string(current + 1, tokenEnd), state);
+                        current = tokenEnd == trimmed.end ? tokenEnd : tokenEnd + 1;
+                        continue;
+                    }
+                    tokenEnd = current;
+                    while (tokenEnd < trimmed.end && !::isspace(static_cast<unsigned char>(*tokenEnd))) {
+                        ++tokenEnd;
+                    }
+                    chunk.labels.emplace_back(std::string(current, tokenEnd), state);
+                    current = tokenEnd;
+                }
+            } else if (startsWith(trimmed, "action")) {
+                STORM_LOG_THROW(!chunk.states.empty() && !hasAction, storm::exceptions::WrongFormatException, "Only DTMCs with a single action per state are supported.");
+                hasAction = true;
+            } else {
+                STORM_LOG_THROW(!chunk.states.empty(), storm::exceptions::WrongFormatException, "The transition " << toString(trimmed) << " does not belong to a state.");
+                char const* colon = static_cast<char const*>(std::memchr(trimmed.begin, ':', trimmed.end - trimmed.begin));
+                char const* current = trimmed.begin;
+                uint64_t target;
+                STORM_LOG_THROW(colon != nullptr && parseNumber(current, colon, target) && target < numberOfStates, storm::exceptions::WrongFormatException,
+                                "Expected a transition of the form <target> : <value> in " << toString(trimmed));
+                std::string value = toString(trim(Line{colon + 1, trimmed.end}));
+                auto it = interned.find(value);
+                if (it == interned.end()) {
+                    it = interned.emplace(value, static_cast<uint32_t>(chunk.functions.size())).first;
+                    chunk.functions.push_back(value);
+                }
+                row.emplace_back(target, it->second);
+            }
+        }
+        if (!chunk.states.empty()) {
+            finishRow();
+        }
+    }
+}
+
+std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> parseDrnModel(std::string const& path, size_t numberOfThreads) {
+    MappedFile file(path);
+    STORM_LOG_THROW(file.valid(), storm::exceptions::FileIoException, "Could not open " << path);
+    char const* data = file.getData();
+    size_t const size = file.getSize();
+
+    DrnHeader header = parseHeader(data, size);
+    if (!header.supported) {
+        std::cout << "The drn file uses features that are left to the parser of storm." << std::endl;
+        return nullptr;
+    }
+    uint64_t const numberOfStates = header.numberOfStates;
+
+    //! The chunks start at a line starting with "state ", so that no state is split
+    std::vector<size_t> starts = {header.modelStart};
+    char const pattern[] = "\nstate ";
+    for (size_t k = 1; k < std::max<size_t>(numberOfThreads, 1); ++k) {
+        size_t target = std::max(starts.back(), header.modelStart + (size - header.modelStart) * k / numberOfThreads);
+        char const* found = std::search(data + target, data + size, pattern, pattern + sizeof(pattern) - 1);
+        if (found == data + size) {
+            break;
+        }
+        starts.push_back(static_cast<size_t>(found - data) + 1);
+    }
+    starts.push_back(size);
+
+    std::vector<Chunk> chunks(starts.size() - 1);
+    std::vector<std::thread> threads;
+    for (size_t k = 0; k < chunks.size(); ++k) {
+        threads.emplace_back([&, k]() {
+            try {
+                scanChunk(data, starts[k], starts[k + 1], numberOfStates, chunks[k]);
+            } catch (std::exception const& e) {
+                chunks[k].error = e.what();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    //! The distinct functions of all chunks, every one is parsed once
+    std::unordered_map<std::string, uint32_t> interned;
+    std::vector<std::string const*> distinct;
+    std::vector<std::vector<uint32_t>> toGlobal(chunks.size());
+    uint64_t expectedState = 0;
+    uint64_t numberOfEntries = 0;
+    for (size_t k = 0; k < chunks.size(); ++k) {
+        STORM_LOG_THROW(chunks[k].error.empty(), storm::exceptions::WrongFormatException, "Error while parsing " << path << ": " << chunks[k].error);
+        for (auto state : chunks[k].states) {
+            STORM_LOG_THROW(state == expectedState, storm::exceptions::WrongFormatException, "The states have to be numbered 0, 1, ... in the order of the file, found state " << state << ".");
+            ++expectedState;
+        }
+        for (auto const& function : chunks[k].functions) {
+            auto it = interned.emplace(function, static_cast<uint32_t>(distinct.size())).first;
+            if (it->second == distinct.size()) {
+                distinct.push_back(&it->first);
+            }
+            toGlobal[k].push_back(it->second);
+        }
+        numberOfEntries += chunks[k].columns.size();
+    }
+    STORM_LOG_THROW(expectedState == numberOfStates, storm::exceptions::WrongFormatException, "The drn file has " << expectedState << " states, @nr_states is " << numberOfStates << ".");
+
+    storm::parser::ValueParser<storm::RationalFunction> valueParser;
+    for (auto const& parameter : header.parameters) {
+        valueParser.addParameter(parameter);
+    }
+    std::vector<storm::RationalFunction> functions;
+    functions.reserve(distinct.size());
+    for (auto const* function : distinct) {
+        functions.push_back(valueParser.parseValue(*function));
+    }
+
+    //! The matrix is assembled in its final layout, the text of a chunk is released as soon as it is used
+    std::vector<uint_fast64_t> rowIndications;
+    rowIndications.reserve(numberOfStates + 1);
+    rowIndications.push_back(0);
+    std::vector<storm::storage::MatrixEntry<uint_fast64_t, storm::RationalFunction>> entries;
+    entries.reserve(numberOfEntries);
+    std::map<std::string, storm::storage::BitVector> labeled;
+    for (size_t k = 0; k < chunks.size(); ++k) {
+        Chunk& chunk = chunks[k];
+        for (size_t row = 0; row < chunk.states.size(); ++row) {
+            for (uint64_t entry = chunk.rowStarts[row]; entry < chunk.rowStarts[row + 1]; ++entry) {
+                entries.emplace_back(chunk.columns[entry], functions[toGlobal[k][chunk.values[entry]]]);
+            }
+            rowIndications.push_back(entries.size());
+        }
+        for (auto const& label : chunk.labels) {
+            auto it = labeled.find(label.first);
+            if (it == labeled.end()) {
+                it = labeled.emplace(label.first, storm::storage::BitVector(numberOfStates)).first;
+            }
+            it->second.set(label.second);
+        }
+        chunk = Chunk();
+    }
+    storm::storage::SparseMatrix<storm::RationalFunction> matrix(numberOfStates, std::move(rowIndications), std::move(entries), boost::none);
+
+    storm::models::sparse::StateLabeling labeling(numberOfStates);
+    for (auto const& label : labeled) {
+        labeling.addLabel(label.first, label.second);
+    }
+    std::cout << "Parsed " << numberOfStates << " states in " << chunks.size() << " chunks, " << functions.size() << " distinct transition functions." << std::endl;
+    return std::make_shared<storm::models::sparse::Dtmc<storm::RationalFunction>>(std::move(matrix), std::move(labeling));
+}
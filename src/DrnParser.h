@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <storm/adapters/RationalFunctionAdapter.h>
+#include <storm/models/sparse/Dtmc.h>
+
+/*!
+ * A parser for parametric DTMCs in the drn format of storm, for large files. The file is memory mapped and the state
+ * blocks are split into contiguous chunks, which are scanned on separate threads: every thread collects the targets,
+ * the labels and the transition functions of its states as text, every distinct function only once. The polynomial
+ * cache of carl is not thread-safe, so the distinct functions of all chunks are then parsed once on a single thread and
+ * the transition matrix is assembled directly in its final layout.
+ */
+
+/*!
+ * Parses a parametric DTMC from a drn file.
+ *
+ * @param path - The path to the drn file.
+ * @param numberOfThreads - The number of threads scanning the states.
+ *
+ * @return The model or nullptr, if the file uses a feature that is not supported here (reward models, a model type
+ *         other than DTMC or an unknown section), then the parser of storm has to be used.
+ */
+std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> parseDrnModel(std::string const& path, size_t numberOfThreads);
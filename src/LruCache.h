@@ -0,0 +1,100 @@
+#pragma once
+
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <cstddef>
+
+/*!
+ * A least recently used cache with a fixed capacity. If a new entry is inserted into a full cache,
+ * the entry that was not used for the longest time is removed.
+ */
+template<typename Key, typename Value>
+class LruCache {
+public:
+    /*!
+     * @param capacity - The maximal number of entries, at least one entry is always kept.
+     */
+    explicit LruCache(std::size_t capacity) : capacity(capacity == 0 ? 1 : capacity) {
+    }
+
+    /*!
+     * Looks up an entry and marks it as the most recently used one.
+     *
+     * @param key - The key of the entry.
+     *
+     * @return A pointer to the value or nullptr if there is no such entry.
+     */
+    Value* get(Key const& key) {
+        auto it = index.find(key);
+        if (it == index.end()) {
+            return nullptr;
+        }
+        entries.splice(entries.begin(), entries, it->second);
+        return &it->second->second;
+    }
+
+    /*!
+     * Inserts or replaces an entry and marks it as the most recently used one.
+     *
+     * @param key - The key of the entry.
+     * @param value - The value of the entry.
+     *
+     * @return A reference to the stored value.
+     */
+    Value& put(Key const& key, Value value) {
+        auto it = index.find(key);
+        if (it != index.end()) {
+            if (evictionHandler) {
+                evictionHandler(it->second->second);
+            }
+            it->second->second = std::move(value);
+            entries.splice(entries.begin(), entries, it->second);
+            return it->second->second;
+        }
+        if (entries.size() >= capacity) {
+            if (evictionHandler) {
+                evictionHandler(entries.back().second);
+            }
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+        entries.emplace_front(key, std::move(value));
+        index[key] = entries.begin();
+        return entries.front().second;
+    }
+
+    /*!
+     * Removes an entry, if it exists.
+     *
+     * @param key - The key of the entry.
+     */
+    void erase(Key const& key) {
+        auto it = index.find(key);
+        if (it != index.end()) {
+            entries.erase(it->second);
+            index.erase(it);
+        }
+    }
+
+    std::size_t size() const {
+        return entries.size();
+    }
+
+    /*!
+     * Sets a function, that is called with every value that is removed because the cache is full or that is replaced
+     * by put, e.g. to release what belongs to it elsewhere.
+     *
+     * @param handler - The function.
+     */
+    void setEvictionHandler(std::function<void(Value&)> handler) {
+        evictionHandler = std::move(handler);
+    }
+
+private:
+    std::size_t capacity;
+    std::function<void(Value&)> evictionHandler;
+    std::list<std::pair<Key, Value>> entries;
+    std::unordered_map<Key, typename std::list<std::pair<Key, Value>>::iterator> index;
+};
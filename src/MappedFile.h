@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*!
+ * A file mapped read-only into memory, unmapped when destroyed.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(std::string const& path) : data(nullptr), size(0) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                data = static_cast<char const*>(mapped);
+                size = info.st_size;
+            }
+        }
+        close(fd);
+    }
+
+    ~MappedFile() {
+        if (data != nullptr) {
+            munmap(const_cast<char*>(data), size);
+        }
+    }
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    bool valid() const {
+        return data != nullptr;
+    }
+
+    char const* getData() const {
+        return data;
+    }
+
+    size_t getSize() const {
+        return size;
+    }
+
+private:
+    char const* data;
+    size_t size;
+};
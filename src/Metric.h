@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*!
+ * The metric, that measures how much an instantiation is changed. It is a weighted norm of the difference of two
+ * instantiations: L1 (sum of the changes), L2 (euclidean, the EC-distance) or LInf (largest change). The weight of a
+ * parameter is how costly it is to change it, a change of d in parameter i counts as weight(i) * d.
+ * All metrics are separable, so the closest point of a box is the projection of the point onto it for each of them.
+ */
+class Metric {
+public:
+    enum class Norm { L1, L2, LInf };
+
+    /*!
+     * @param norm - The norm.
+     * @param weights - One weight per parameter, if empty every parameter has weight 1.
+     */
+    explicit Metric(Norm norm = Norm::L2, std::vector<double> weights = std::vector<double>()) : norm(norm), weights(std::move(weights)) {
+        for (double w : this->weights) {
+            if (!(w > 0)) {
+                throw std::invalid_argument("The weights of the metric must be positive.");
+            }
+        }
+    }
+
+    /*!
+     * @param str - "L1", "L2" or "Linf".
+     *
+     * @return The norm.
+     */
+    static Norm parseNorm(std::string const& str) {
+        if (str == "L1") {
+            return Norm::L1;
+        } else if (str == "L2") {
+            return Norm::L2;
+        } else if (str == "Linf") {
+            return Norm::LInf;
+        }
+        throw std::invalid_argument("Unknown metric " + str + ", use L1, L2 or Linf.");
+    }
+
+    Norm getNorm() const {
+        return norm;
+    }
+
+    /*!
+     * @return The name used in the output, the unweighted L2 metric is the EC-distance.
+     */
+    std::string getName() const {
+        std::string res = norm == Norm::L1 ? "L1" : (norm == Norm::L2 ? "EC" : "Linf");
+        return weights.empty() ? res : "weighted " + res;
+    }
+
+    double weight(size_t i) const {
+        return weights.empty() ? 1.0 : weights[i];
+    }
+
+    /*!
+     * Adds the change in one parameter to a partial distance. Partial distances of L2 are squared, see finish.
+     *
+     * @param partial - The partial distance of the other parameters.
+     * @param i - The index of the parameter.
+     * @param diff - The change of the parameter.
+     *
+     * @return The partial distance including the parameter.
+     */
+    double accumulate(double partial, size_t i, double diff) const {
+        double const change = weight(i) * std::abs(diff);
+        switch (norm) {
+            case Norm::L1:
+                return partial + change;
+            case Norm::L2:
+                return partial + change * change;
+            default:
+                return std::max(partial, change);
+        }
+    }
+
+    /*!
+     * @param partial - The partial distance over all parameters.
+     *
+     * @return The distance.
+     */
+    double finish(double partial) const {
+        return norm == Norm::L2 ? std::sqrt(partial) : partial;
+    }
+
+    /*!
+     * Calculates the distance between two instantiations.
+     *
+     * @param oldInst - The old instantiation of the parameters.
+     * @param newInst - The new instantiation of the parameters.
+     *
+     * @return The distance.
+     */
+    double distance(std::vector<double> const& oldInst, std::vector<double> const& newInst) const {
+        double res = 0;
+        for (size_t i = 0; i < newInst.size(); ++i) {
+            res = accumulate(res, i, newInst[i] - oldInst[i]);
+        }
+        return finish(res);
+    }
+
+    /*!
+     * Calculates how far parameter i can change in a box around an instantiation, such that every point of the box is
+     * within epsilon of it. For L2 that is epsilon / sqrt(n), for L1 epsilon / n and for LInf epsilon, divided by the weight.
+     *
+     * @param epsilon - The maximal distance.
+     * @param i - The index of the parameter.
+     * @param numberOfParameters - The number of parameters.
+     *
+     * @return The half width of the box in parameter i.
+     */
+    double radius(double epsilon, size_t i, size_t numberOfParameters) const {
+        double const n = static_cast<double>(std::max<size_t>(numberOfParameters, 1));
+        switch (norm) {
+            case Norm::L1:
+                return epsilon / (n * weight(i));
+            case Norm::L2:
+                return epsilon / (std::sqrt(n) * weight(i));
+            default:
+                return epsilon / weight(i);
+        }
+    }
+
+private:
+    Norm norm;
+    std::vector<double> weights;
+};
@@ -0,0 +1,220 @@
+#include "Monotonicity.h"
+
+#include <algorithm>
+
+#include <storm/utility/constants.h>
+
+namespace {
+    typedef ParameterPolynomial::Coefficient Coefficient;
+
+    Coefficient fromInteger(int_fast64_t value) {
+        return storm::utility::convertNumber<Coefficient>(value);
+    }
+
+    Coefficient binomial(uint32_t n, uint32_t k) {
+        Coefficient res = storm::utility::one<Coefficient>();
+        for (uint32_t t = 1; t <= k; ++t) {
+            res = res * fromInteger(n - k + t) / fromInteger(t);
+        }
+        return res;
+    }
+
+    ParameterPolynomial::Sign combine(ParameterPolynomial::Sign sign, Coefficient const& value) {
+        typedef ParameterPolynomial::Sign Sign;
+        if (storm::utility::isZero(value) || sign == Sign::Unknown) {
+            return sign;
+        }
+        bool positive = storm::utility::zero<Coefficient>() < value;
+        if (sign == Sign::Zero) {
+            return positive ? Sign::NonNegative : Sign::NonPositive;
+        }
+        return (sign == Sign::NonNegative) == positive ? sign : Sign::Unknown;
+    }
+}
+
+ParameterPolynomial::ParameterPolynomial(storm::RawPolynomial const& polynomial, ParameterSpace const& space) {
+    for (auto const& term : polynomial) {
+        Term res{term.coeff(), {}};
+        if (term.monomial()) {
+            for (auto const& exponent : *term.monomial()) {
+                res.exponents.emplace_back(space.getIndex(exponent.first.name()), exponent.second);
+            }
+        }
+        terms.push_back(res);
+    }
+}
+
+Coefficient ParameterPolynomial::evaluate(std::vector<Coefficient> const& point) const {
+    Coefficient res = storm::utility::zero<Coefficient>();
+    for (auto const& term : terms) {
+        Coefficient value = term.coefficient;
+        for (auto const& exponent : term.exponents) {
+            for (uint32_t e = 0; e < exponent.second; ++e) {
+                value = value * point[exponent.first];
+            }
+        }
+        res = res + value;
+    }
+    return res;
+}
+
+ParameterPolynomial::Sign ParameterPolynomial::signOnUnitBox(uint64_t maxCoefficients) const {
+    //! The parameters that occur, their degree and their stride in the dense tensor of coefficients
+    std::vector<size_t> used;
+    std::vector<uint32_t> degrees;
+    for (auto const& term : terms) {
+        for (auto const& exponent : term.exponents) {
+            auto it = std::find(used.begin(), used.end(), exponent.first);
+            if (it == used.end()) {
+                used.push_back(exponent.first);
+                degrees.push_back(exponent.second);
+            } else {
+                degrees[it - used.begin()] = std::max(degrees[it - used.begin()], exponent.second);
+            }
+        }
+    }
+    std::vector<uint64_t> strides(used.size());
+    uint64_t size = 1;
+    for (size_t k = 0; k < used.size(); ++k) {
+        strides[k] = size;
+        if (size > maxCoefficients / (degrees[k] + 1)) {
+            return Sign::Unknown;
+        }
+        size *= degrees[k] + 1;
+    }
+
+    std::vector<Coefficient> tensor(size, storm::utility::zero<Coefficient>());
+    for (auto const& term : terms) {
+        uint64_t offset = 0;
+        for (auto const& exponent : term.exponents) {
+            offset += strides[std::find(used.begin(), used.end(), exponent.first) - used.begin()] * exponent.second;
+        }
+        tensor[offset] = tensor[offset] + term.coefficient;
+    }
+
+    //! The Bernstein coefficients on [0,1] of a_0 + a_1 x + ... + a_d x^d are b_i = sum_{j <= i} C(i,j) / C(d,j) a_j, the
+    //! multivariate ones are obtained by transforming along one parameter after the other
+    for (size_t k = 0; k < used.size(); ++k) {
+        uint32_t const d = degrees[k];
+        std::vector<std::vector<Coefficient>> factors(d + 1);
+        for (uint32_t i = 0; i <= d; ++i) {
+            for (uint32_t j = 0; j <= i; ++j) {
+                factors[i].push_back(binomial(i, j) / binomial(d, j));
+            }
+        }
+        std::vector<Coefficient> fiber(d + 1);
+        for (uint64_t base = 0; base < size; ++base) {
+            if ((base / strides[k]) % (d + 1) != 0) {
+                continue;
+            }
+            for (uint32_t j = 0; j <= d; ++j) {
+                fiber[j] = tensor[base + j * strides[k]];
+            }
+            for (uint32_t i = 0; i <= d; ++i) {
+                Coefficient value = storm::utility::zero<Coefficient>();
+                for (uint32_t j = 0; j <= i; ++j) {
+                    value = value + factors[i][j] * fiber[j];
+                }
+                tensor[base + i * strides[k]] = value;
+            }
+        }
+    }
+
+    Sign res = Sign::Zero;
+    for (auto const& value : tensor) {
+        res = combine(res, value);
+        if (res == Sign::Unknown) {
+            break;
+        }
+    }
+    return res;
+}
+
+FormulaMonotonicity::FormulaMonotonicity(ParameterSpace const& space, storm::RationalFunction const& function, storm::logic::ComparisonType comparison,
+                                         ParameterPolynomial::Coefficient const& threshold)
+    : variables(space.getVariables()), comparison(comparison), threshold(threshold) {
+    typedef ParameterPolynomial::Sign Sign;
+    storm::RawPolynomial const functionNumerator = function.nominatorAsPolynomial();
+    storm::RawPolynomial const functionDenominator = function.denominatorAsPolynomial();
+    numerator = ParameterPolynomial(functionNumerator, space);
+    denominator = ParameterPolynomial(functionDenominator, space);
+
+    bool const lowerBound = comparison == storm::logic::ComparisonType::Greater || comparison == storm::logic::ComparisonType::GreaterEqual;
+    for (auto const& var : variables) {
+        //! The denominator of the derivative is D^2, which is positive where f is defined
+        storm::RawPolynomial const derivative = functionNumerator.derivative(var) * functionDenominator - functionNumerator * functionDenominator.derivative(var);
+        Sign sign = ParameterPolynomial(derivative, space).signOnUnitBox();
+        if (sign == Sign::Zero) {
+            monotonicity.push_back(Monotonicity::Constant);
+        } else if (sign == Sign::Unknown) {
+            monotonicity.push_back(Monotonicity::Unknown);
+        } else {
+            monotonicity.push_back((sign == Sign::NonNegative) == lowerBound ? Monotonicity::Increasing : Monotonicity::Decreasing);
+        }
+    }
+}
+
+bool FormulaMonotonicity::allMonotone() const {
+    return numberOfMonotone() == monotonicity.size();
+}
+
+size_t FormulaMonotonicity::numberOfMonotone() const {
+    return std::count_if(monotonicity.begin(), monotonicity.end(), [](Monotonicity m) { return m != Monotonicity::Unknown; });
+}
+
+FormulaMonotonicity::Region FormulaMonotonicity::collapse(Region const& region, bool worst) const {
+    Region::Valuation lower = region.getLowerBoundaries();
+    Region::Valuation upper = region.getUpperBoundaries();
+    for (size_t i = 0; i < variables.size(); ++i) {
+        if (monotonicity[i] == Monotonicity::Unknown) {
+            continue;
+        }
+        auto const& var = variables[i];
+        bool const takeLower = monotonicity[i] == Monotonicity::Constant || (monotonicity[i] == Monotonicity::Increasing) == worst;
+        auto value = takeLower ? lower[var] : upper[var];
+        lower[var] = value;
+        upper[var] = value;
+    }
+    return Region(lower, upper);
+}
+
+storm::modelchecker::RegionResult FormulaMonotonicity::decide(Region const& region) const {
+    auto toPoint = [this](Region::Valuation const& valuation) {
+        std::vector<ParameterPolynomial::Coefficient> res;
+        for (auto const& var : variables) {
+            res.push_back(valuation.at(var));
+        }
+        return res;
+    };
+    boost::optional<bool> worst = satisfies(toPoint(collapse(region, true).getLowerBoundaries()));
+    if (worst && worst.get()) {
+        return storm::modelchecker::RegionResult::AllSat;
+    }
+    boost::optional<bool> best = satisfies(toPoint(collapse(region, false).getLowerBoundaries()));
+    if (best && !best.get()) {
+        return storm::modelchecker::RegionResult::AllViolated;
+    }
+    boost::optional<bool> center = satisfies(toPoint(region.getCenterPoint()));
+    if (!worst || !best || !center) {
+        return storm::modelchecker::RegionResult::Unknown;
+    }
+    return center.get() ? storm::modelchecker::RegionResult::CenterSat : storm::modelchecker::RegionResult::CenterViolated;
+}
+
+boost::optional<bool> FormulaMonotonicity::satisfies(std::vector<ParameterPolynomial::Coefficient> const& point) const {
+    ParameterPolynomial::Coefficient denominatorValue = denominator.evaluate(point);
+    if (storm::utility::isZero(denominatorValue)) {
+        return boost::none;
+    }
+    ParameterPolynomial::Coefficient value = numerator.evaluate(point) / denominatorValue;
+    switch (comparison) {
+        case storm::logic::ComparisonType::Greater:
+            return threshold < value;
+        case storm::logic::ComparisonType::GreaterEqual:
+            return threshold <= value;
+        case storm::logic::ComparisonType::Less:
+            return value < threshold;
+        default:
+            return value <= threshold;
+    }
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include <storm/adapters/RationalFunctionAdapter.h>
+#include <storm/logic/ComparisonType.h>
+#include <storm/storage/ParameterRegion.h>
+#include <storm-pars/modelchecker/region/RegionResult.h>
+
+#include "ParameterSpace.h"
+
+/*!
+ * A polynomial in the parameters of a ParameterSpace with exact coefficients. Unlike the polynomials of carl, which
+ * share a cache, it can be evaluated on several threads at once.
+ */
+class ParameterPolynomial {
+public:
+    typedef storm::RationalFunctionCoefficient Coefficient;
+
+    enum class Sign { Zero, NonNegative, NonPositive, Unknown };
+
+    ParameterPolynomial() = default;
+
+    /*!
+     * @param polynomial - The polynomial of carl.
+     * @param space - The parameters, every variable of the polynomial must be one of them.
+     */
+    ParameterPolynomial(storm::RawPolynomial const& polynomial, ParameterSpace const& space);
+
+    /*!
+     * @param point - A value for every parameter.
+     *
+     * @return The value of the polynomial.
+     */
+    Coefficient evaluate(std::vector<Coefficient> const& point) const;
+
+    /*!
+     * Bounds the sign of the polynomial on the unit box [0,1]^n with its Bernstein expansion: the polynomial lies
+     * between the smallest and the largest Bernstein coefficient, so it is non-negative if all of them are.
+     *
+     * @param maxCoefficients - The largest number of Bernstein coefficients computed, the sign is Unknown for
+     *                          polynomials of a higher degree.
+     *
+     * @return The sign, Unknown if the coefficients have different signs.
+     */
+    Sign signOnUnitBox(uint64_t maxCoefficients = 1 << 20) const;
+
+private:
+    struct Term {
+        Coefficient coefficient;
+        //! The index of the parameter and its exponent
+        std::vector<std::pair<size_t, uint32_t>> exponents;
+    };
+
+    std::vector<Term> terms;
+};
+
+/*!
+ * How the satisfaction of a formula changes with a parameter: Increasing if raising the parameter never turns a
+ * satisfying instantiation into a violating one, Decreasing if lowering it never does.
+ */
+enum class Monotonicity { Increasing, Decreasing, Constant, Unknown };
+
+/*!
+ * The monotonicity of a formula P~t [...] in every parameter on the whole parameter space [0,1]^n. For the solution
+ * function f = N / D, the sign of the partial derivative is the sign of N'D - ND', which is bounded on [0,1]^n.
+ * A region, whose formula is monotone in all parameters, is decided exactly on its corners: it is AllSat if the corner,
+ * where the formula is satisfied least, satisfies it, and AllViolated if the corner, where it is satisfied most, violates it.
+ */
+class FormulaMonotonicity {
+public:
+    typedef storm::storage::ParameterRegion<storm::RationalFunction> Region;
+
+    /*!
+     * @param space - The parameters.
+     * @param function - The solution function of the formula, its polynomials are read from the polynomial cache of carl.
+     * @param comparison - The comparison of the bound of the formula.
+     * @param threshold - The threshold of the bound of the formula.
+     */
+    FormulaMonotonicity(ParameterSpace const& space, storm::RationalFunction const& function, storm::logic::ComparisonType comparison,
+                        ParameterPolynomial::Coefficient const& threshold);
+
+    Monotonicity get(size_t i) const {
+        return monotonicity[i];
+    }
+
+    /*!
+     * @return true, if the formula is monotone or constant in every parameter.
+     */
+    bool allMonotone() const;
+
+    /*!
+     * @return The number of parameters, in which the formula is monotone or constant.
+     */
+    size_t numberOfMonotone() const;
+
+    /*!
+     * Collapses the monotone parameters of the region to a single value: the bound, where the formula is satisfied least
+     * (worst) or most. The formula is satisfied on the whole region, if it is satisfied on the region collapsed to the
+     * worst bounds, and violated on the whole region, if it is violated on the region collapsed to the best bounds.
+     *
+     * @param region - The region.
+     * @param worst - If the worst or the best bounds are taken.
+     *
+     * @return The collapsed region.
+     */
+    Region collapse(Region const& region, bool worst) const;
+
+    /*!
+     * Decides a region on its corners and its center, only if the formula is monotone in all parameters.
+     *
+     * @param region - The region.
+     *
+     * @return AllSat, AllViolated, CenterSat or CenterViolated; Unknown if the solution function is not defined at one of the points.
+     */
+    storm::modelchecker::RegionResult decide(Region const& region) const;
+
+    /*!
+     * Checks the formula exactly on the solution function.
+     *
+     * @param point - A value for every parameter.
+     *
+     * @return If the point satisfies the formula, none if the solution function is not defined there.
+     */
+    boost::optional<bool> satisfies(std::vector<ParameterPolynomial::Coefficient> const& point) const;
+
+private:
+    std::vector<storm::RationalFunctionVariable> variables;
+    std::vector<Monotonicity> monotonicity;
+    ParameterPolynomial numerator;
+    ParameterPolynomial denominator;
+    storm::logic::ComparisonType comparison;
+    ParameterPolynomial::Coefficient threshold;
+};
@@ -0,0 +1,140 @@
+#include "ParameterSpace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+#include <boost/algorithm/string.hpp>
+
+#include <storm/utility/constants.h>
+#include <storm/utility/macros.h>
+#include <storm/exceptions/InvalidArgumentException.h>
+
+namespace {
+    /*!
+     * Converts a bound to a rational number with the denominator 10^9.
+     */
+    storm::RationalFunctionCoefficient toCoefficient(double value) {
+        int_fast64_t const denominator = 1000000000;
+        return storm::utility::convertNumber<storm::RationalFunctionCoefficient>(static_cast<int_fast64_t>(std::llround(value * denominator))) /
+               storm::utility::convertNumber<storm::RationalFunctionCoefficient>(denominator);
+    }
+}
+
+double stringToDouble(std::string str) {
+    std::string::size_type positionOfNumerator = str.find("/");
+    if (positionOfNumerator == std::string::npos) { //if it is not a fraction just convert and return
+        return std::stod(str);
+    }
+    double lb = std::stod((str.substr(0, positionOfNumerator)));
+    double ub = std::stod((str.substr(positionOfNumerator + 1)));
+    return lb / ub;
+}
+
+ParameterSpace::ParameterSpace(std::set<storm::RationalFunctionVariable> const& parameters) : variables(parameters.begin(), parameters.end()) {
+    for (size_t i = 0; i < variables.size(); ++i) {
+        names.push_back(variables[i].name());
+        indices[names.back()] = i;
+    }
+}
+
+size_t ParameterSpace::getIndex(std::string const& name) const {
+    auto it = indices.find(name);
+    STORM_LOG_THROW(it != indices.end(), storm::exceptions::InvalidArgumentException, "The model has no parameter " << name);
+    return it->second;
+}
+
+Box ParameterSpace::parseBox(std::string const& region_string) const {
+    Box res;
+    res.lower.assign(size(), 0);
+    res.upper.assign(size(), 0);
+    std::vector<bool> found(size(), false);
+
+    std::vector<std::string> parameterBoundaries;
+    boost::split(parameterBoundaries, region_string, boost::is_any_of(","));
+    for (auto const& par : parameterBoundaries) {
+        if (std::all_of(par.begin(), par.end(), ::isspace)) { //skip this string if it only consists of space
+            continue;
+        }
+        //!Get the position of the lower bound
+        std::string::size_type positionOfFirstRelation = par.find("<=");
+        STORM_LOG_THROW(positionOfFirstRelation != std::string::npos, storm::exceptions::InvalidArgumentException, "When parsing the region" << par << " I could not find a '<=' after the first number");
+
+        //!Get the position of the upper bound
+        std::string::size_type positionOfSecondRelation = par.find("<=", positionOfFirstRelation + 2);
+        STORM_LOG_THROW(positionOfSecondRelation != std::string::npos, storm::exceptions::InvalidArgumentException, "When parsing the region" << par << " I could not find a '<=' after the parameter");
+
+        //!Get the parameter as string and the bounds as doubles
+        std::string parameter = par.substr(positionOfFirstRelation + 2, positionOfSecondRelation - (positionOfFirstRelation + 2));
+        parameter.erase(std::remove_if(parameter.begin(), parameter.end(), ::isspace), parameter.end());
+
+        size_t index = getIndex(parameter);
+        res.lower[index] = stringToDouble(par.substr(0, positionOfFirstRelation));
+        res.upper[index] = stringToDouble(par.substr(positionOfSecondRelation + 2));
+        found[index] = true;
+    }
+    for (size_t i = 0; i < size(); ++i) {
+        STORM_LOG_THROW(found[i], storm::exceptions::InvalidArgumentException, "The region has no bounds for the parameter " << names[i]);
+    }
+    return res;
+}
+
+Box ParameterSpace::toBox(Region const& region) const {
+    Box res;
+    res.lower.reserve(size());
+    res.upper.reserve(size());
+    for (auto const& var : variables) {
+        res.lower.push_back(storm::utility::convertNumber<double>(region.getLowerBoundary(var)));
+        res.upper.push_back(storm::utility::convertNumber<double>(region.getUpperBoundary(var)));
+    }
+    return res;
+}
+
+ParameterSpace::Region ParameterSpace::toRegion(Box const& box) const {
+    Region::Valuation lower;
+    Region::Valuation upper;
+    for (size_t i = 0; i < size(); ++i) {
+        lower[variables[i]] = toCoefficient(box.lower[i]);
+        upper[variables[i]] = toCoefficient(box.upper[i]);
+    }
+    return Region(lower, upper);
+}
+
+ParameterSpace::Region ParameterSpace::toExactRegion(Box const& box) const {
+    Region::Valuation lower;
+    Region::Valuation upper;
+    for (size_t i = 0; i < size(); ++i) {
+        lower[variables[i]] = storm::utility::convertNumber<storm::RationalFunctionCoefficient>(box.lower[i]);
+        upper[variables[i]] = storm::utility::convertNumber<storm::RationalFunctionCoefficient>(box.upper[i]);
+    }
+    return Region(lower, upper);
+}
+
+Instantiation ParameterSpace::toInstantiation(Region::Valuation const& valuation) const {
+    Instantiation res;
+    res.reserve(size());
+    for (auto const& var : variables) {
+        auto it = valuation.find(var);
+        STORM_LOG_THROW(it != valuation.end(), storm::exceptions::InvalidArgumentException, "The valuation has no value for " << var.name());
+        res.push_back(storm::utility::convertNumber<double>(it->second));
+    }
+    return res;
+}
+
+std::vector<std::pair<std::string, double>> ParameterSpace::toNamed(Instantiation const& instantiation) const {
+    std::vector<std::pair<std::string, double>> res;
+    for (size_t i = 0; i < size(); ++i) {
+        res.push_back(std::make_pair(names[i], instantiation[i]));
+    }
+    return res;
+}
+
+std::string ParameterSpace::toString(Box const& box) const {
+    std::ostringstream res;
+    res << std::setprecision(8) << std::noshowpoint;
+    for (size_t i = 0; i < size(); ++i) {
+        res << (i == 0 ? "" : ",") << box.lower[i] << "<=" << names[i] << "<=" << box.upper[i];
+    }
+    return res.str();
+}
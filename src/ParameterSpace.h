@@ -0,0 +1,130 @@
+#pragma once
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <storm/adapters/RationalFunctionAdapter.h>
+#include <storm/storage/ParameterRegion.h>
+
+/*!
+ * A value for every parameter, addressed by the index of the parameter in a ParameterSpace.
+ */
+typedef std::vector<double> Instantiation;
+
+/*!
+ * A box of parameter values as structure of arrays, lower[i] and upper[i] are the bounds of the parameter with index i.
+ */
+struct Box {
+    std::vector<double> lower;
+    std::vector<double> upper;
+};
+
+/*!
+ * Function to make string into double, the string can be a fraction, e.g. "1/3".
+ *
+ * @param str - String.
+ *
+ * @return The double of the string.
+ */
+double stringToDouble(std::string str);
+
+/*!
+ * The parameters of a model in a fixed order. Regions and instantiations are stored by the index of the parameter,
+ * strings are only parsed for the user input and only printed for the output.
+ */
+class ParameterSpace {
+public:
+    typedef storm::storage::ParameterRegion<storm::RationalFunction> Region;
+
+    /*!
+     * @param parameters - The parameters of the model.
+     */
+    explicit ParameterSpace(std::set<storm::RationalFunctionVariable> const& parameters);
+
+    size_t size() const {
+        return variables.size();
+    }
+
+    std::vector<storm::RationalFunctionVariable> const& getVariables() const {
+        return variables;
+    }
+
+    storm::RationalFunctionVariable const& getVariable(size_t index) const {
+        return variables[index];
+    }
+
+    std::string const& getName(size_t index) const {
+        return names[index];
+    }
+
+    /*!
+     * @param name - The name of a parameter.
+     *
+     * @return The index of the parameter, throws if there is no such parameter.
+     */
+    size_t getIndex(std::string const& name) const;
+
+    /*!
+     * Parses a region string, e.g. "0.5<=p<=0.5,0.2<=q<=0.3". Every parameter must have bounds.
+     *
+     * @param region_string - The region string.
+     *
+     * @return The box.
+     */
+    Box parseBox(std::string const& region_string) const;
+
+    /*!
+     * @param region - A region of the model.
+     *
+     * @return The bounds of the region.
+     */
+    Box toBox(Region const& region) const;
+
+    /*!
+     * Builds the region for PLA. The bounds are rounded to 9 decimal places, so that the rational numbers stay small.
+     *
+     * @param box - The bounds.
+     *
+     * @return The region.
+     */
+    Region toRegion(Box const& box) const;
+
+    /*!
+     * Builds the region with the exact rational values of the bounds, for certification. Every double is a rational number
+     * with a power of two as denominator, so the region is exactly the box.
+     *
+     * @param box - The bounds.
+     *
+     * @return The region.
+     */
+    Region toExactRegion(Box const& box) const;
+
+    /*!
+     * @param valuation - A valuation of the parameters, e.g. the center point of a region.
+     *
+     * @return The instantiation.
+     */
+    Instantiation toInstantiation(Region::Valuation const& valuation) const;
+
+    /*!
+     * @param instantiation - An instantiation.
+     *
+     * @return The pairs of parameter name and value, for the output.
+     */
+    std::vector<std::pair<std::string, double>> toNamed(Instantiation const& instantiation) const;
+
+    /*!
+     * @param box - The bounds.
+     *
+     * @return The region string, e.g. "0.1<=p<=0.9,0.2<=q<=0.3".
+     */
+    std::string toString(Box const& box) const;
+
+private:
+    std::vector<storm::RationalFunctionVariable> variables;
+    std::vector<std::string> names;
+    std::unordered_map<std::string, size_t> indices;
+};
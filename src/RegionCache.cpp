@@ -0,0 +1,310 @@
+#include "RegionCache.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+namespace {
+    char const MAGIC[8] = {'P', 'L', 'A', 'R', 'E', 'G', '0', '1'};
+
+    struct Header {
+        char magic[8];
+        uint64_t key;
+        uint64_t dimension;
+    };
+
+    //! Slivers of the box thinner than this are not kept when subtracting a cached region
+    double const SLIVER = 1e-12;
+    //! The subtraction is given up, if the uncovered part of a box consists of more boxes
+    size_t const MAX_PIECES = 4096;
+
+    /*!
+     * Subtracts the box given by lower and upper from part and appends the remaining boxes, without slivers.
+     */
+    void subtract(Box const& part, std::vector<double> const& lower, std::vector<double> const& upper, std::vector<Box>& result) {
+        for (size_t d = 0; d < lower.size(); ++d) {
+            if (part.upper[d] <= lower[d] || upper[d] <= part.lower[d]) {
+                result.push_back(part);
+                return;
+            }
+        }
+        Box rest = part;
+        for (size_t d = 0; d < lower.size(); ++d) {
+            if (rest.lower[d] < lower[d]) {
+                if (lower[d] - rest.lower[d] > SLIVER) {
+                    Box below = rest;
+                    below.upper[d] = lower[d];
+                    result.push_back(below);
+                }
+                rest.lower[d] = lower[d];
+            }
+            if (upper[d] < rest.upper[d]) {
+                if (rest.upper[d] - upper[d] > SLIVER) {
+                    Box above = rest;
+                    above.lower[d] = upper[d];
+                    result.push_back(above);
+                }
+                rest.upper[d] = upper[d];
+            }
+        }
+    }
+
+    bool readAll(int fd, std::vector<char>& data) {
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            return false;
+        }
+        data.resize(info.st_size);
+        size_t done = 0;
+        while (done < data.size()) {
+            ssize_t n = pread(fd, data.data() + done, data.size() - done, done);
+            if (n <= 0) {
+                return false;
+            }
+            done += n;
+        }
+        return true;
+    }
+
+    bool writeAll(int fd, char const* data, size_t size) {
+        size_t done = 0;
+        while (done < size) {
+            ssize_t n = write(fd, data + done, size - done);
+            if (n <= 0) {
+                return false;
+            }
+            done += n;
+        }
+        return true;
+    }
+}
+
+uint64_t RegionCache::key(std::vector<std::string> const& parts) {
+    uint64_t hash = 14695981039346656037ull;
+    for (auto const& part : parts) {
+        //!The terminating zero separates the parts
+        for (size_t i = 0; i <= part.size(); ++i) {
+            hash ^= static_cast<unsigned char>(part.c_str()[i]);
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+RegionCache::RegionCache(std::string const& directory, uint64_t key, size_t dimension, uint64_t sizeLimit)
+    : directory(directory), cacheKey(key), dimension(dimension), sizeLimit(sizeLimit), boxes(dimension) {
+    if (mkdir(directory.c_str(), 0777) != 0 && errno != EEXIST) {
+        throw std::invalid_argument("Could not create the cache directory " + directory);
+    }
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.regions", static_cast<unsigned long long>(key));
+    path = directory + "/" + name;
+    load();
+}
+
+void RegionCache::load() {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    std::vector<char> data;
+    flock(fd, LOCK_SH);
+    bool read = readAll(fd, data);
+    flock(fd, LOCK_UN);
+    close(fd);
+    Header header;
+    if (!read || data.size() < sizeof(Header)) {
+        return;
+    }
+    std::memcpy(&header, data.data(), sizeof(Header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.key != cacheKey || header.dimension != dimension) {
+        return;
+    }
+
+    //!A record that is only partly written by a concurrent run is left out
+    size_t const recordSize = 2 * dimension * sizeof(double) + 1;
+    size_t numberOfRecords = (data.size() - sizeof(Header)) / recordSize;
+    boxes.reserve(numberOfRecords);
+    verdicts.reserve(numberOfRecords);
+    std::vector<double> lower(dimension);
+    std::vector<double> upper(dimension);
+    char const* record = data.data() + sizeof(Header);
+    for (size_t i = 0; i < numberOfRecords; ++i, record += recordSize) {
+        std::memcpy(lower.data(), record, dimension * sizeof(double));
+        std::memcpy(upper.data(), record + dimension * sizeof(double), dimension * sizeof(double));
+        boxes.add(lower, upper);
+        verdicts.push_back(static_cast<uint8_t>(record[recordSize - 1]));
+    }
+    if (!boxes.empty()) {
+        index.reset(new BoxIndex(boxes));
+    }
+    //!Marks the file as used, the files used the longest time ago are evicted first
+    utime(path.c_str(), nullptr);
+}
+
+bool RegionCache::cover(Box const& box, std::vector<std::pair<Box, Verdict>>& pieces) const {
+    pieces.clear();
+    if (!index) {
+        return false;
+    }
+    std::vector<size_t> overlapping;
+    index->overlapping(box.lower, box.upper, overlapping);
+    if (overlapping.empty()) {
+        return false;
+    }
+
+    //!The box is covered, if nothing is left after subtracting all overlapping regions
+    std::vector<Box> rest(1, box);
+    std::vector<double> lower(dimension);
+    std::vector<double> upper(dimension);
+    for (size_t i = 0; i < overlapping.size() && !rest.empty(); ++i) {
+        for (size_t d = 0; d < dimension; ++d) {
+            lower[d] = boxes.lower(overlapping[i], d);
+            upper[d] = boxes.upper(overlapping[i], d);
+        }
+        std::vector<Box> next;
+        for (auto const& part : rest) {
+            subtract(part, lower, upper, next);
+        }
+        if (next.size() > MAX_PIECES) {
+            return false;
+        }
+        rest.swap(next);
+    }
+    if (!rest.empty()) {
+        return false;
+    }
+
+    for (size_t i : overlapping) {
+        Box piece;
+        for (size_t d = 0; d < dimension; ++d) {
+            piece.lower.push_back(std::max(box.lower[d], boxes.lower(i, d)));
+            piece.upper.push_back(std::min(box.upper[d], boxes.upper(i, d)));
+        }
+        pieces.emplace_back(piece, static_cast<Verdict>(verdicts[i]));
+    }
+    return true;
+}
+
+void RegionCache::add(Box const& box, Verdict verdict) {
+    if (verdict != Verdict::AllSat && verdict != Verdict::AllViolated) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.insert(pending.end(), box.lower.begin(), box.lower.end());
+    pending.insert(pending.end(), box.upper.begin(), box.upper.end());
+    pendingVerdicts.push_back(static_cast<uint8_t>(verdict));
+}
+
+uint64_t RegionCache::save() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (pendingVerdicts.empty()) {
+        return 0;
+    }
+    size_t const recordSize = 2 * dimension * sizeof(double) + 1;
+    std::vector<char> data(pendingVerdicts.size() * recordSize);
+    for (size_t i = 0; i < pendingVerdicts.size(); ++i) {
+        std::memcpy(data.data() + i * recordSize, pending.data() + 2 * dimension * i, 2 * dimension * sizeof(double));
+        data[i * recordSize + recordSize - 1] = static_cast<char>(pendingVerdicts[i]);
+    }
+    uint64_t written = pendingVerdicts.size();
+    pending.clear();
+    pendingVerdicts.clear();
+
+    //!Runs on the same key write one after the other. While waiting for the lock, another run may have compacted or
+    //!evicted the file, then the records would be appended to the removed file, so the file is opened again.
+    int fd;
+    struct stat info;
+    while (true) {
+        fd = open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0666);
+        if (fd < 0) {
+            throw std::runtime_error("Could not open the region cache " + path);
+        }
+        flock(fd, LOCK_EX);
+        struct stat current;
+        if (fstat(fd, &info) == 0 && stat(path.c_str(), &current) == 0 && info.st_ino == current.st_ino && info.st_dev == current.st_dev) {
+            break;
+        }
+        flock(fd, LOCK_UN);
+        close(fd);
+    }
+    bool ok = true;
+    if (info.st_size == 0) {
+        Header header;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.key = cacheKey;
+        header.dimension = dimension;
+        ok = writeAll(fd, reinterpret_cast<char const*>(&header), sizeof(Header));
+    }
+    ok = ok && writeAll(fd, data.data(), data.size());
+    uint64_t fileSize = static_cast<uint64_t>(info.st_size == 0 ? sizeof(Header) : info.st_size) + data.size();
+
+    //!A file over the limit keeps its newest regions, that fill half of the limit
+    if (ok && sizeLimit > 0 && fileSize > sizeLimit) {
+        std::vector<char> content;
+        if (readAll(fd, content) && content.size() >= sizeof(Header)) {
+            size_t numberOfRecords = (content.size() - sizeof(Header)) / recordSize;
+            size_t kept = std::min<size_t>(numberOfRecords, (sizeLimit / 2 > sizeof(Header) ? sizeLimit / 2 - sizeof(Header) : 0) / recordSize);
+            std::string temporary = path + ".tmp" + std::to_string(getpid());
+            int out = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+            if (out >= 0) {
+                bool copied = writeAll(out, content.data(), sizeof(Header)) &&
+                              writeAll(out, content.data() + sizeof(Header) + (numberOfRecords - kept) * recordSize, kept * recordSize);
+                close(out);
+                if (copied && std::rename(temporary.c_str(), path.c_str()) == 0) {
+                    fileSize = sizeof(Header) + kept * recordSize;
+                } else {
+                    std::remove(temporary.c_str());
+                }
+            }
+        }
+    }
+    flock(fd, LOCK_UN);
+    close(fd);
+    if (!ok) {
+        throw std::runtime_error("Could not write the region cache " + path);
+    }
+    if (sizeLimit > 0) {
+        evict(fileSize);
+    }
+    return written;
+}
+
+void RegionCache::evict(uint64_t fileSize) {
+    DIR* dir = opendir(directory.c_str());
+    if (dir == nullptr) {
+        return;
+    }
+    //!The other cache files with their last use and size
+    std::vector<std::pair<time_t, std::pair<std::string, uint64_t>>> files;
+    uint64_t total = fileSize;
+    std::string const suffix = ".regions";
+    std::string own = path.substr(directory.size() + 1);
+    while (struct dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name == own || name.size() <= suffix.size() || name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+            continue;
+        }
+        struct stat info;
+        if (stat((directory + "/" + name).c_str(), &info) == 0) {
+            files.emplace_back(info.st_mtime, std::make_pair(name, static_cast<uint64_t>(info.st_size)));
+            total += info.st_size;
+        }
+    }
+    closedir(dir);
+    std::sort(files.begin(), files.end());
+    for (size_t i = 0; i < files.size() && total > sizeLimit; ++i) {
+        if (std::remove((directory + "/" + files[i].second.first).c_str()) == 0) {
+            total -= files[i].second.second;
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <storm-pars/modelchecker/region/RegionResult.h>
+
+#include "BoxArray.h"
+#include "ParameterSpace.h"
+
+/*!
+ * A cache of decided regions on disk, shared by all runs on the same model, formulae and settings. Every such key has
+ * its own file in the cache directory, a header followed by one record per region: the lower and the upper bounds as
+ * double and the verdict, AllSat or AllViolated, as a byte. New regions are appended, so runs can use the file at the
+ * same time. The regions of the file are loaded into a BoxIndex, a region of a new run is covered, if the cached regions
+ * overlapping it leave nothing of it, then it is decided by them without a check.
+ * The cache directory is kept below a size limit: a file over the limit keeps only its newest regions and the files
+ * that were not used for the longest time are removed.
+ */
+class RegionCache {
+public:
+    typedef storm::modelchecker::RegionResult Verdict;
+
+    /*!
+     * Computes the key of a cache file (FNV-1a).
+     *
+     * @param parts - Everything the verdicts depend on, e.g. the checksum of the model file, the formulae and the parameters.
+     *
+     * @return The key.
+     */
+    static uint64_t key(std::vector<std::string> const& parts);
+
+    /*!
+     * Loads the cached regions of the key, if there are any.
+     *
+     * @param directory - The cache directory, it is created if it does not exist.
+     * @param key - The key, see key.
+     * @param dimension - The number of parameters.
+     * @param sizeLimit - The maximal size of the cache directory in bytes.
+     */
+    RegionCache(std::string const& directory, uint64_t key, size_t dimension, uint64_t sizeLimit);
+
+    RegionCache(RegionCache const&) = delete;
+    RegionCache& operator=(RegionCache const&) = delete;
+
+    /*!
+     * Checks if the box is covered by the cached regions. Slivers thinner than 1e-12, which come from rounding the
+     * rational bounds of the regions to double, are considered covered.
+     *
+     * @param box - The box.
+     * @param pieces - If the box is covered, set to the parts of the box in the cached regions with their verdicts.
+     *
+     * @return true if the box is covered.
+     */
+    bool cover(Box const& box, std::vector<std::pair<Box, Verdict>>& pieces) const;
+
+    /*!
+     * Adds a region decided by the current run, it is written with save. Other verdicts than AllSat and AllViolated
+     * are ignored. Can be called from several threads.
+     *
+     * @param box - The bounds of the region.
+     * @param verdict - The verdict.
+     */
+    void add(Box const& box, Verdict verdict);
+
+    /*!
+     * Appends the regions added since the last call to the file and enforces the size limit.
+     *
+     * @return The number of regions written.
+     */
+    uint64_t save();
+
+    /*!
+     * @return The number of regions loaded from the file.
+     */
+    size_t size() const {
+        return verdicts.size();
+    }
+
+private:
+    void load();
+    void evict(uint64_t fileSize);
+
+    std::string directory;
+    std::string path;
+    uint64_t cacheKey;
+    size_t dimension;
+    uint64_t sizeLimit;
+
+    BoxArray boxes;
+    std::vector<uint8_t> verdicts;
+    std::unique_ptr<BoxIndex> index;
+
+    std::mutex mutex;
+    std::vector<double> pending;
+    std::vector<uint8_t> pendingVerdicts;
+};
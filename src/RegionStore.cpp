@@ -0,0 +1,93 @@
+#include "RegionStore.h"
+
+#include <stdexcept>
+
+RegionStore::RegionStore(size_t dimension, bool keepViolated, uint64_t memoryLimit)
+    : dimension(dimension), keepViolated(keepViolated), memoryLimit(memoryLimit), file(nullptr), numberOfSpilled(0) {
+}
+
+RegionStore::~RegionStore() {
+    if (file != nullptr) {
+        std::fclose(file);
+    }
+}
+
+void RegionStore::add(Box const& box, Verdict verdict) {
+    std::lock_guard<std::mutex> lock(mutex);
+    counts[verdict]++;
+    if (verdict == Verdict::AllViolated && !keepViolated) {
+        return;
+    }
+    bounds.insert(bounds.end(), box.lower.begin(), box.lower.end());
+    bounds.insert(bounds.end(), box.upper.begin(), box.upper.end());
+    verdicts.push_back(static_cast<uint8_t>(verdict));
+    if (memoryLimit > 0 && bounds.size() * sizeof(double) + verdicts.size() > memoryLimit) {
+        spill();
+    }
+}
+
+uint64_t RegionStore::count(Verdict verdict) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = counts.find(verdict);
+    return it == counts.end() ? 0 : it->second;
+}
+
+uint64_t RegionStore::total() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t res = 0;
+    for (auto const& entry : counts) {
+        res += entry.second;
+    }
+    return res;
+}
+
+uint64_t RegionStore::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return numberOfSpilled + verdicts.size();
+}
+
+uint64_t RegionStore::spilled() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return numberOfSpilled;
+}
+
+void RegionStore::spill() {
+    if (file == nullptr) {
+        //! The file is removed automatically when it is closed
+        file = std::tmpfile();
+        if (file == nullptr) {
+            throw std::runtime_error("Could not create a temporary file for the regions.");
+        }
+    }
+    std::fseek(file, 0, SEEK_END);
+    long offset = std::ftell(file);
+    if (std::fwrite(bounds.data(), sizeof(double), bounds.size(), file) != bounds.size() ||
+        std::fwrite(verdicts.data(), 1, verdicts.size(), file) != verdicts.size()) {
+        throw std::runtime_error("Could not write the regions to the temporary file.");
+    }
+    spilledBlocks.emplace_back(offset, verdicts.size());
+    numberOfSpilled += verdicts.size();
+    //! The memory is released, not only cleared
+    std::vector<double>().swap(bounds);
+    std::vector<uint8_t>().swap(verdicts);
+}
+
+void RegionStore::forEachBlock(std::function<void(Block const&)> const& function) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<double> blockBounds;
+    std::vector<uint8_t> blockVerdicts;
+    for (auto const& block : spilledBlocks) {
+        blockBounds.resize(2 * dimension * block.second);
+        blockVerdicts.resize(block.second);
+        std::fflush(file);
+        std::fseek(file, block.first, SEEK_SET);
+        if (std::fread(blockBounds.data(), sizeof(double), blockBounds.size(), file) != blockBounds.size() ||
+            std::fread(blockVerdicts.data(), 1, blockVerdicts.size(), file) != blockVerdicts.size()) {
+            throw std::runtime_error("Could not read the regions from the temporary file.");
+        }
+        function(Block{dimension, block.second, blockBounds.data(), blockVerdicts.data()});
+    }
+    if (!verdicts.empty()) {
+        function(Block{dimension, verdicts.size(), bounds.data(), verdicts.data()});
+    }
+}
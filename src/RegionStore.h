@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <storm-pars/modelchecker/region/RegionResult.h>
+
+#include "ParameterSpace.h"
+
+/*!
+ * The regions found by the refinement, stored compactly: every region is a record of fixed width in an arena, the lower
+ * bounds and then the upper bounds of all parameters as double, and its verdict is a byte in a separate array.
+ * AllViolated regions are only counted, unless they are kept explicitly. If a memory limit is given, the arena is
+ * written to a temporary file whenever it grows beyond the limit, so the memory used does not grow with the depth of
+ * the refinement. Regions can be added from several threads.
+ */
+class RegionStore {
+public:
+    typedef storm::modelchecker::RegionResult Verdict;
+
+    /*!
+     * A block of regions, either the arena or a part of it read back from the temporary file.
+     */
+    struct Block {
+        size_t dimension;
+        size_t size;
+        //! The lower bounds of region i are at bounds[2 * dimension * i], followed by the upper bounds
+        double const* bounds;
+        uint8_t const* verdicts;
+
+        double const* lower(size_t i) const {
+            return bounds + 2 * dimension * i;
+        }
+
+        double const* upper(size_t i) const {
+            return bounds + 2 * dimension * i + dimension;
+        }
+
+        Verdict verdict(size_t i) const {
+            return static_cast<Verdict>(verdicts[i]);
+        }
+
+        Box box(size_t i) const {
+            return Box{std::vector<double>(lower(i), lower(i) + dimension), std::vector<double>(upper(i), upper(i) + dimension)};
+        }
+    };
+
+    /*!
+     * @param dimension - The number of parameters.
+     * @param keepViolated - If AllViolated regions are stored.
+     * @param memoryLimit - The maximal size of the arena in bytes, 0 for no limit.
+     */
+    RegionStore(size_t dimension, bool keepViolated = false, uint64_t memoryLimit = 0);
+
+    ~RegionStore();
+
+    RegionStore(RegionStore const&) = delete;
+    RegionStore& operator=(RegionStore const&) = delete;
+
+    /*!
+     * Adds a region.
+     *
+     * @param box - The bounds of the region.
+     * @param verdict - The verdict of the region.
+     */
+    void add(Box const& box, Verdict verdict);
+
+    /*!
+     * @param verdict - A verdict.
+     *
+     * @return The number of regions added with the verdict, including the ones that are not stored.
+     */
+    uint64_t count(Verdict verdict) const;
+
+    /*!
+     * @return The number of regions added, including the ones that are not stored.
+     */
+    uint64_t total() const;
+
+    /*!
+     * @return The number of stored regions.
+     */
+    uint64_t size() const;
+
+    /*!
+     * @return The number of stored regions that are in the temporary file.
+     */
+    uint64_t spilled() const;
+
+    size_t getDimension() const {
+        return dimension;
+    }
+
+    /*!
+     * Calls the function for every block of stored regions, first the ones in the temporary file in the order they were
+     * written, then the arena. The pointers of a block are only valid during the call, the function must not use the store.
+     *
+     * @param function - The function.
+     */
+    void forEachBlock(std::function<void(Block const&)> const& function) const;
+
+private:
+    void spill();
+
+    size_t dimension;
+    bool keepViolated;
+    uint64_t memoryLimit;
+
+    mutable std::mutex mutex;
+    std::vector<double> bounds;
+    std::vector<uint8_t> verdicts;
+    std::map<Verdict, uint64_t> counts;
+
+    //! The temporary file, created at the first spill, and the offset and number of regions of every block in it
+    std::FILE* file;
+    std::vector<std::pair<long, size_t>> spilledBlocks;
+    uint64_t numberOfSpilled;
+};
@@ -0,0 +1,148 @@
+#include "RunReport.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+void RunReport::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    phases.clear();
+    regions.clear();
+    checked = 0;
+    savedChecks = 0;
+    splitsPerDepth.clear();
+    estimated = false;
+    result.clear();
+}
+
+void RunReport::addPhase(std::string const& name, std::string const& detail, double milliseconds) {
+    Phase phase{name, detail, milliseconds, currentRssKb(), peakRssKb()};
+    std::lock_guard<std::mutex> lock(mutex);
+    phases.push_back(phase);
+}
+
+void RunReport::countRegions(std::string const& verdict, uint64_t number) {
+    std::lock_guard<std::mutex> lock(mutex);
+    regions[verdict] += number;
+}
+
+void RunReport::countChecked(uint64_t number) {
+    std::lock_guard<std::mutex> lock(mutex);
+    checked += number;
+}
+
+void RunReport::countSavedChecks(uint64_t number) {
+    std::lock_guard<std::mutex> lock(mutex);
+    savedChecks += number;
+}
+
+void RunReport::countSplits(uint64_t depth, uint64_t number) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (splitsPerDepth.size() <= depth) {
+        splitsPerDepth.resize(depth + 1, 0);
+    }
+    splitsPerDepth[depth] += number;
+}
+
+void RunReport::markEstimated() {
+    std::lock_guard<std::mutex> lock(mutex);
+    estimated = true;
+}
+
+void RunReport::setResult(std::string const& key, std::string const& jsonValue) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : result) {
+        if (entry.first == key) {
+            entry.second = jsonValue;
+            return;
+        }
+    }
+    result.emplace_back(key, jsonValue);
+}
+
+void RunReport::write(std::ostream& out, double totalMilliseconds) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    out << std::setprecision(10);
+    out << "{\"totalMilliseconds\": " << totalMilliseconds << ", \"peakRssKb\": " << peakRssKb() << ",\n";
+    out << " \"phases\": [";
+    for (size_t i = 0; i < phases.size(); ++i) {
+        Phase const& phase = phases[i];
+        out << (i == 0 ? "\n" : ",\n") << "  {\"name\": " << quote(phase.name) << ", \"detail\": " << quote(phase.detail) << ", \"milliseconds\": " << phase.milliseconds
+            << ", \"rssKb\": " << phase.rssKb << ", \"peakRssKb\": " << phase.peakRssKb << "}";
+    }
+    out << "],\n \"regions\": {\"checked\": " << checked << ", \"checkedEstimated\": " << (estimated ? "true" : "false") << ", \"savedByMonotonicity\": " << savedChecks;
+    for (auto const& entry : regions) {
+        out << ", " << quote(entry.first) << ": " << entry.second;
+    }
+    out << "},\n \"splitsPerDepth\": [";
+    for (size_t i = 0; i < splitsPerDepth.size(); ++i) {
+        out << (i == 0 ? "" : ", ") << splitsPerDepth[i];
+    }
+    out << "],\n \"splitsPerDepthEstimated\": " << (estimated ? "true" : "false") << ",\n \"result\": {";
+    for (size_t i = 0; i < result.size(); ++i) {
+        out << (i == 0 ? "" : ", ") << quote(result[i].first) << ": " << result[i].second;
+    }
+    out << "}}\n";
+}
+
+void RunReport::write(std::string const& path, double totalMilliseconds) const {
+    std::ofstream file(path);
+    if (!file) {
+        throw std::invalid_argument("Could not write the report " + path);
+    }
+    write(file, totalMilliseconds);
+}
+
+long RunReport::currentRssKb() {
+    long pages = 0;
+    long resident = 0;
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (statm == nullptr) {
+        return 0;
+    }
+    if (std::fscanf(statm, "%ld %ld", &pages, &resident) != 2) {
+        resident = 0;
+    }
+    std::fclose(statm);
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+long RunReport::peakRssKb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+std::string RunReport::quote(std::string const& str) {
+    std::ostringstream res;
+    res << '"';
+    for (char c : str) {
+        switch (c) {
+            case '"':
+                res << "\\\"";
+                break;
+            case '\\':
+                res << "\\\\";
+                break;
+            case '\n':
+                res << "\\n";
+                break;
+            case '\t':
+                res << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    res << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+                } else {
+                    res << c;
+                }
+        }
+    }
+    res << '"';
+    return res.str();
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*!
+ * Records what happened during a run: the wall time and memory of every phase, the regions checked by PLA and the
+ * result. The report is written as a single JSON object, so that it can be read by monitoring without parsing the log.
+ * All functions can be called from several threads.
+ */
+class RunReport {
+public:
+    /*!
+     * A finished phase. The memory is the resident set size at the end of the phase and the peak resident set size of
+     * the process so far, both in KB.
+     */
+    struct Phase {
+        std::string name;
+        std::string detail;
+        double milliseconds;
+        long rssKb;
+        long peakRssKb;
+    };
+
+    /*!
+     * Removes everything recorded so far.
+     */
+    void clear();
+
+    /*!
+     * Records a finished phase.
+     *
+     * @param name - The name of the phase, e.g. parse or pla.
+     * @param detail - Further information, e.g. the epsilon of a PLA attempt, may be empty.
+     * @param milliseconds - The wall time of the phase.
+     */
+    void addPhase(std::string const& name, std::string const& detail, double milliseconds);
+
+    /*!
+     * Counts regions with the given verdict, e.g. AllSat.
+     */
+    void countRegions(std::string const& verdict, uint64_t number);
+
+    /*!
+     * Counts regions analyzed by a region checker.
+     */
+    void countChecked(uint64_t number);
+
+    /*!
+     * Counts region checks, that were decided on the monotonicity of the formulae instead of by parameter lifting.
+     */
+    void countSavedChecks(uint64_t number);
+
+    /*!
+     * Counts regions split at the given depth, the initial region has depth 0.
+     */
+    void countSplits(uint64_t depth, uint64_t number = 1);
+
+    /*!
+     * Marks the checked regions and the splits as estimated, e.g. if they are reconstructed from a partition instead of
+     * being counted.
+     */
+    void markEstimated();
+
+    /*!
+     * Sets a field of the result, the value is written as given, so strings must be quoted.
+     */
+    void setResult(std::string const& key, std::string const& jsonValue);
+
+    /*!
+     * Writes the report as JSON.
+     *
+     * @param out - The stream.
+     * @param totalMilliseconds - The wall time of the whole run.
+     */
+    void write(std::ostream& out, double totalMilliseconds) const;
+
+    /*!
+     * Writes the report to a file, throws if the file cannot be written.
+     */
+    void write(std::string const& path, double totalMilliseconds) const;
+
+    /*!
+     * @return The current resident set size of the process in KB.
+     */
+    static long currentRssKb();
+
+    /*!
+     * @return The peak resident set size of the process in KB.
+     */
+    static long peakRssKb();
+
+    /*!
+     * @return The string quoted and escaped for JSON.
+     */
+    static std::string quote(std::string const& str);
+
+private:
+    mutable std::mutex mutex;
+    std::vector<Phase> phases;
+    std::map<std::string, uint64_t> regions;
+    uint64_t checked = 0;
+    uint64_t savedChecks = 0;
+    std::vector<uint64_t> splitsPerDepth;
+    bool estimated = false;
+    std::vector<std::pair<std::string, std::string>> result;
+};
+
+/*!
+ * Measures the wall time of a phase from its construction to stop() or its destruction and records it in the report.
+ */
+class PhaseTimer {
+public:
+    PhaseTimer(RunReport& report, std::string name, std::string detail = "")
+        : report(report), name(std::move(name)), detail(std::move(detail)), start(std::chrono::steady_clock::now()), stopped(false) {
+    }
+
+    ~PhaseTimer() {
+        stop();
+    }
+
+    PhaseTimer(PhaseTimer const&) = delete;
+    PhaseTimer& operator=(PhaseTimer const&) = delete;
+
+    void stop() {
+        if (!stopped) {
+            stopped = true;
+            report.addPhase(name, detail, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+    }
+
+private:
+    RunReport& report;
+    std::string name;
+    std::string detail;
+    std::chrono::steady_clock::time_point start;
+    bool stopped;
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*!
+ * A pool of threads, where every thread has its own queue of tasks. A task can create new tasks, which are put into the queue
+ * of the thread that processes it. A thread with an empty queue steals tasks from the other threads.
+ * A thread takes the newest task of its own queue, so the tasks created by a task are processed first (depth first) and
+ * only few tasks are waiting at a time. The initial tasks are processed in their order. Stealing takes the oldest task of
+ * another queue (e.g. the biggest region). A thread without a task to steal waits until a task is created.
+ */
+template<typename Task>
+class WorkStealingPool {
+public:
+    typedef std::function<void(Task)> Spawn;
+    typedef std::function<void(size_t, Task&, Spawn const&)> Process;
+
+    /*!
+     * @param numberOfThreads - The number of threads, at least one thread is used.
+     */
+    explicit WorkStealingPool(size_t numberOfThreads) : numberOfThreads(numberOfThreads == 0 ? 1 : numberOfThreads) {
+    }
+
+    /*!
+     * Processes the tasks and all tasks created by them, returns when all tasks are done.
+     * If a task throws, the remaining tasks are dropped and the first exception is rethrown.
+     *
+     * @param initial - The first tasks, distributed round robin over the threads.
+     * @param process - Called with the index of the thread, the task and a function to create new tasks.
+     */
+    void run(std::vector<Task> initial, Process const& process) {
+        queues.clear();
+        for (size_t i = 0; i < numberOfThreads; ++i) {
+            queues.emplace_back(new Queue());
+        }
+        pending = initial.size();
+        queued = initial.size();
+        aborted = false;
+        error = nullptr;
+        for (size_t i = 0; i < initial.size(); ++i) {
+            queues[i % numberOfThreads]->tasks.push_front(std::move(initial[i]));
+        }
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < numberOfThreads; ++i) {
+            threads.emplace_back(&WorkStealingPool::work, this, i, std::cref(process));
+        }
+        work(0, process);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    size_t getNumberOfThreads() const {
+        return numberOfThreads;
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool pop(size_t index, Task& task) {
+        for (size_t i = 0; i < numberOfThreads; ++i) {
+            Queue& queue = *queues[(index + i) % numberOfThreads];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                if (i == 0) {
+                    task = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                } else {
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //! Wakes up the waiting threads, the lock is taken so that a thread cannot miss it between its check and its wait
+    void wake(bool all) {
+        {
+            std::lock_guard<std::mutex> lock(idleMutex);
+        }
+        if (all) {
+            idle.notify_all();
+        } else {
+            idle.notify_one();
+        }
+    }
+
+    void work(size_t index, Process const& process) {
+        Spawn spawn = [this, index](Task task) {
+            ++pending;
+            ++queued;
+            {
+                Queue& queue = *queues[index];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.tasks.push_back(std::move(task));
+            }
+            wake(false);
+        };
+        while (pending > 0 && !aborted) {
+            Task task;
+            if (!pop(index, task)) {
+                std::unique_lock<std::mutex> lock(idleMutex);
+                idle.wait(lock, [this] { return pending == 0 || aborted || queued > 0; });
+                continue;
+            }
+            --queued;
+            try {
+                process(index, task, spawn);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                aborted = true;
+            }
+            if (--pending == 0 || aborted) {
+                wake(true);
+            }
+        }
+    }
+
+    size_t numberOfThreads;
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::atomic<size_t> pending;
+    //! The number of tasks in the queues, a thread waits while it is zero
+    std::atomic<size_t> queued;
+    std::atomic<bool> aborted;
+    std::mutex idleMutex;
+    std::condition_variable idle;
+    std::mutex errorMutex;
+    std::exception_ptr error;
+};
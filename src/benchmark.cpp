@@ -0,0 +1,501 @@
+//! Benchmark harness for storm-project-starter.
+//!
+//! Sweeps the model families of a suite over the number of parameters, epsilon, depthLimit and refThreshold. Every
+//! configuration is run as its own process, so that the peak memory of one run does not influence the next one.
+//! The results are written as CSV or JSON and can be compared with a stored baseline (CSV) to find regressions.
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifndef SOLVER_PATH
+#define SOLVER_PATH "./storm-project-starter"
+#endif
+
+std::string solverPath = SOLVER_PATH;
+std::string suitePath = "benchmarks/suite.tsv";
+std::string sizes = "1,2,4,8,16";
+std::string epsilons = "0.05";
+std::string depthLimits = "5";
+std::string refThresholds = "0.05";
+std::string families = "";
+std::string solverOptions = "";
+std::string format = "csv";
+std::string outputPath = "";
+std::string baselinePath = "";
+double tolerance = 0.2;
+unsigned timeout = 600;
+
+/*!
+ * A model family of the suite.
+ */
+struct Family {
+    std::string name;
+    //! The path to the drn file, {n} is replaced by the number of parameters
+    std::string modelPattern;
+    std::string property;
+    //! The initial value of every parameter
+    std::string initialValue;
+};
+
+/*!
+ * One configuration of the sweep and what was measured for it.
+ */
+struct Run {
+    std::string family;
+    std::string parameters;
+    std::string epsilon;
+    std::string depthLimit;
+    std::string refThreshold;
+    std::string status = "error";
+    double parseMs = 0;
+    double plaMs = 0;
+    double totalMs = 0;
+    long allSat = 0;
+    long allViolated = 0;
+    long centerSat = 0;
+    long centerViolated = 0;
+    long unknown = 0;
+    double distance = -1;
+    long peakRssKb = 0;
+
+    std::string key() const {
+        return family + "/" + parameters + "/" + epsilon + "/" + depthLimit + "/" + refThreshold;
+    }
+};
+
+/*!
+ * Splits a string at the separator, empty parts are dropped.
+ */
+std::vector<std::string> split(std::string const& str, char separator) {
+    std::vector<std::string> res;
+    std::stringstream stream(str);
+    std::string part;
+    while (std::getline(stream, part, separator)) {
+        if (!part.empty()) {
+            res.push_back(part);
+        }
+    }
+    return res;
+}
+
+/*!
+ * Reads the suite, every line is family, model pattern, property and initial value separated by tabs.
+ * Empty lines and lines starting with # are skipped.
+ */
+std::vector<Family> readSuite(std::string const& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::invalid_argument("Could not open the suite " + path);
+    }
+    std::vector<Family> res;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::vector<std::string> fields = split(line, '\t');
+        if (fields.size() != 4) {
+            throw std::invalid_argument("The suite line " + line + " does not have 4 fields.");
+        }
+        res.push_back(Family{fields[0], fields[1], fields[2], fields[3]});
+    }
+    return res;
+}
+
+/*!
+ * Reads the names of the parameters from the @parameters section of a drn file.
+ */
+std::vector<std::string> readParameters(std::string const& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::invalid_argument("Could not open the model " + path);
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line == "@parameters") {
+            std::getline(file, line);
+            return split(line, ' ');
+        }
+    }
+    return std::vector<std::string>();
+}
+
+/*!
+ * Builds the initial instantiation as a region string, every parameter has the same value.
+ */
+std::string initialRegion(std::vector<std::string> const& parameters, std::string const& value) {
+    std::string res;
+    for (auto const& parameter : parameters) {
+        res += (res.empty() ? "" : ",") + value + "<=" + parameter + "<=" + value;
+    }
+    return res;
+}
+
+/*!
+ * Gets the time after the given prefix in a line of the solver output in milliseconds. The stopwatch of storm prints
+ * seconds, e.g. "1.234s", the units ms, min and h are converted as well.
+ */
+double parseMilliseconds(std::string const& line, std::string const& prefix) {
+    std::string text = line.substr(prefix.size());
+    size_t end = 0;
+    double value = std::stod(text, &end);
+    while (end < text.size() && text[end] == ' ') {
+        ++end;
+    }
+    std::string unit = text.substr(end);
+    if (unit.compare(0, 2, "ms") == 0) {
+        return value;
+    } else if (unit.compare(0, 3, "min") == 0) {
+        return value * 60000;
+    } else if (unit.compare(0, 1, "h") == 0) {
+        return value * 3600000;
+    }
+    return value * 1000;
+}
+
+/*!
+ * Parses the output of the solver. Times of several PLA calls are summed, the region counts and the distance of the
+ * last call are kept.
+ */
+void parseOutput(std::string const& output, Run& run) {
+    std::istringstream stream(output);
+    std::string line;
+    bool found = false;
+    bool infeasible = false;
+    while (std::getline(stream, line)) {
+        if (line.compare(0, 30, "Time for model input parsing: ") == 0) {
+            run.parseMs += parseMilliseconds(line, "Time for model input parsing: ");
+        } else if (line.compare(0, 14, "Time for PLA: ") == 0) {
+            run.plaMs += parseMilliseconds(line, "Time for PLA: ");
+        } else if (line.compare(0, 9, "Regions: ") == 0) {
+            std::istringstream counts(line.substr(9));
+            std::string word;
+            counts >> run.allSat >> word >> run.allViolated >> word >> run.centerSat >> word >> run.centerViolated >> word >> run.unknown;
+        } else if (line.find(" - distance between the original and new instantiation:") != std::string::npos) {
+            run.distance = std::stod(line);
+            found = true;
+        } else if (line.find("No feasible solution exists") != std::string::npos) {
+            infeasible = true;
+        }
+    }
+    run.status = found ? "found" : (infeasible ? "infeasible" : "not_found");
+}
+
+/*!
+ * Runs the solver for one configuration and measures it.
+ */
+void execute(Family const& family, Run& run) {
+    std::string modelPath = family.modelPattern;
+    std::string::size_type position = modelPath.find("{n}");
+    if (position != std::string::npos) {
+        modelPath.replace(position, 3, run.parameters);
+    }
+    std::vector<std::string> args = {solverPath, modelPath, family.property, initialRegion(readParameters(modelPath), family.initialValue), run.epsilon,
+                                     "--depthLimit", run.depthLimit, "--refThreshold", run.refThreshold};
+    for (auto const& option : split(solverOptions, ' ')) {
+        args.push_back(option);
+    }
+
+    int output[2];
+    if (pipe(output) != 0) {
+        throw std::runtime_error("Could not create a pipe.");
+    }
+    struct timeval start;
+    gettimeofday(&start, nullptr);
+    pid_t pid = fork();
+    if (pid < 0) {
+        throw std::runtime_error("Could not start the solver.");
+    }
+    if (pid == 0) {
+        dup2(output[1], STDOUT_FILENO);
+        dup2(output[1], STDERR_FILENO);
+        close(output[0]);
+        close(output[1]);
+        std::vector<char*> argv;
+        for (auto& arg : args) {
+            argv.push_back(&arg[0]);
+        }
+        argv.push_back(nullptr);
+        execv(solverPath.c_str(), argv.data());
+        _exit(127);
+    }
+    close(output[1]);
+    //!The solver is killed, when it runs longer than the timeout (wall clock)
+    bool timedOut = false;
+    std::string text;
+    char buffer[1 << 16];
+    while (true) {
+        struct timeval now;
+        gettimeofday(&now, nullptr);
+        double elapsedMs = (now.tv_sec - start.tv_sec) * 1000.0 + (now.tv_usec - start.tv_usec) / 1000.0;
+        if (!timedOut && elapsedMs >= timeout * 1000.0) {
+            kill(pid, SIGKILL);
+            timedOut = true;
+        }
+        struct pollfd readable = {output[0], POLLIN, 0};
+        int ready = poll(&readable, 1, timedOut ? -1 : static_cast<int>(std::min(timeout * 1000.0 - elapsedMs, 1000.0)) + 1);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready < 0) {
+            break;
+        }
+        if (ready == 0) {
+            continue;
+        }
+        ssize_t n = read(output[0], buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        text.append(buffer, n);
+    }
+    close(output[0]);
+
+    int status;
+    struct rusage usage;
+    wait4(pid, &status, 0, &usage);
+    struct timeval end;
+    gettimeofday(&end, nullptr);
+    run.totalMs = (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_usec - start.tv_usec) / 1000.0;
+    run.peakRssKb = usage.ru_maxrss;
+
+    parseOutput(text, run);
+    if (timedOut) {
+        run.status = "timeout";
+    } else if (WIFSIGNALED(status)) {
+        run.status = "crashed";
+    } else if (WEXITSTATUS(status) != 0) {
+        run.status = "error";
+    }
+}
+
+std::vector<std::string> const COLUMNS = {"family", "parameters", "epsilon", "depthLimit", "refThreshold", "status", "parseMs", "plaMs", "totalMs",
+                                          "allSat", "allViolated", "centerSat", "centerViolated", "unknown", "distance", "peakRssKb"};
+
+std::vector<std::string> values(Run const& run) {
+    auto str = [](double value) {
+        std::ostringstream res;
+        res << std::setprecision(10) << value;
+        return res.str();
+    };
+    return {run.family, run.parameters, run.epsilon, run.depthLimit, run.refThreshold, run.status, str(run.parseMs), str(run.plaMs), str(run.totalMs),
+            std::to_string(run.allSat), std::to_string(run.allViolated), std::to_string(run.centerSat), std::to_string(run.centerViolated),
+            std::to_string(run.unknown), str(run.distance), std::to_string(run.peakRssKb)};
+}
+
+void writeCsv(std::ostream& out, std::vector<Run> const& runs) {
+    for (size_t i = 0; i < COLUMNS.size(); ++i) {
+        out << (i == 0 ? "" : ",") << COLUMNS[i];
+    }
+    out << "\n";
+    for (auto const& run : runs) {
+        auto fields = values(run);
+        for (size_t i = 0; i < fields.size(); ++i) {
+            out << (i == 0 ? "" : ",") << fields[i];
+        }
+        out << "\n";
+    }
+}
+
+void writeJson(std::ostream& out, std::vector<Run> const& runs) {
+    out << "[\n";
+    for (size_t r = 0; r < runs.size(); ++r) {
+        auto fields = values(runs[r]);
+        out << "  {";
+        for (size_t i = 0; i < fields.size(); ++i) {
+            //!The first six columns are strings, the others numbers
+            bool quoted = i < 6;
+            out << (i == 0 ? "" : ", ") << "\"" << COLUMNS[i] << "\": " << (quoted ? "\"" : "") << fields[i] << (quoted ? "\"" : "");
+        }
+        out << "}" << (r + 1 < runs.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+/*!
+ * Reads a baseline written with --format csv.
+ */
+std::map<std::string, Run> readBaseline(std::string const& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::invalid_argument("Could not open the baseline " + path);
+    }
+    std::map<std::string, Run> res;
+    std::string line;
+    std::getline(file, line);
+    if (split(line, ',') != COLUMNS) {
+        throw std::invalid_argument("The baseline " + path + " has different columns.");
+    }
+    while (std::getline(file, line)) {
+        std::vector<std::string> fields = split(line, ',');
+        if (fields.size() != COLUMNS.size()) {
+            continue;
+        }
+        Run run;
+        run.family = fields[0];
+        run.parameters = fields[1];
+        run.epsilon = fields[2];
+        run.depthLimit = fields[3];
+        run.refThreshold = fields[4];
+        run.status = fields[5];
+        run.parseMs = std::stod(fields[6]);
+        run.plaMs = std::stod(fields[7]);
+        run.totalMs = std::stod(fields[8]);
+        run.distance = std::stod(fields[14]);
+        run.peakRssKb = std::stol(fields[15]);
+        res[run.key()] = run;
+    }
+    return res;
+}
+
+/*!
+ * Compares the runs with the baseline. Times and memory regress, if they grew by more than the tolerance (differences
+ * below 50ms and 1MB are ignored as noise), the distance regresses, if it grew at all, and a found instantiation must stay found.
+ *
+ * @return The number of regressions.
+ */
+size_t compare(std::vector<Run> const& runs, std::map<std::string, Run> const& baseline) {
+    size_t regressions = 0;
+    auto report = [&regressions](Run const& run, std::string const& what, double before, double after) {
+        std::cout << "REGRESSION " << run.key() << ": " << what << " " << before << " -> " << after << std::endl;
+        regressions++;
+    };
+    for (auto const& run : runs) {
+        auto it = baseline.find(run.key());
+        if (it == baseline.end()) {
+            std::cout << "NEW " << run.key() << std::endl;
+            continue;
+        }
+        Run const& base = it->second;
+        if (base.status == "found" && run.status != "found") {
+            std::cout << "REGRESSION " << run.key() << ": status " << base.status << " -> " << run.status << std::endl;
+            regressions++;
+            continue;
+        }
+        if (run.plaMs > base.plaMs * (1 + tolerance) && run.plaMs - base.plaMs > 50) {
+            report(run, "plaMs", base.plaMs, run.plaMs);
+        }
+        if (run.parseMs > base.parseMs * (1 + tolerance) && run.parseMs - base.parseMs > 50) {
+            report(run, "parseMs", base.parseMs, run.parseMs);
+        }
+        if (run.peakRssKb > base.peakRssKb * (1 + tolerance) && run.peakRssKb - base.peakRssKb > 1024) {
+            report(run, "peakRssKb", base.peakRssKb, run.peakRssKb);
+        }
+        if (run.status == "found" && base.status == "found" && run.distance > base.distance + 1e-9) {
+            report(run, "distance", base.distance, run.distance);
+        }
+    }
+    return regressions;
+}
+
+/*!
+ * Sets the options from the user input.
+ */
+void setOptions(int argc, char* argv[]) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        std::string value = argv[i + 1];
+        if (option == "--solver") {
+            solverPath = value;
+        } else if (option == "--suite") {
+            suitePath = value;
+        } else if (option == "--families") {
+            families = value;
+        } else if (option == "--sizes") {
+            sizes = value;
+        } else if (option == "--epsilon") {
+            epsilons = value;
+        } else if (option == "--depthLimit") {
+            depthLimits = value;
+        } else if (option == "--refThreshold") {
+            refThresholds = value;
+        } else if (option == "--options") {
+            solverOptions = value;
+        } else if (option == "--format") {
+            format = value;
+        } else if (option == "--output") {
+            outputPath = value;
+        } else if (option == "--compare") {
+            baselinePath = value;
+        } else if (option == "--tolerance") {
+            tolerance = std::stod(value);
+        } else if (option == "--timeout") {
+            timeout = std::stoul(value);
+        } else {
+            throw std::invalid_argument("There is no such option: " + option);
+        }
+    }
+    if (argc % 2 == 0) {
+        throw std::invalid_argument("The option " + std::string(argv[argc - 1]) + " has no value.");
+    }
+}
+
+int main(int argc, char* argv[]) {
+    setOptions(argc, argv);
+
+    std::vector<std::string> selected = split(families, ',');
+    std::vector<Run> runs;
+    for (auto const& family : readSuite(suitePath)) {
+        if (!selected.empty() && std::find(selected.begin(), selected.end(), family.name) == selected.end()) {
+            continue;
+        }
+        for (auto const& size : split(sizes, ',')) {
+            for (auto const& epsilon : split(epsilons, ',')) {
+                for (auto const& depthLimit : split(depthLimits, ',')) {
+                    for (auto const& refThreshold : split(refThresholds, ',')) {
+                        Run run;
+                        run.family = family.name;
+                        run.parameters = size;
+                        run.epsilon = epsilon;
+                        run.depthLimit = depthLimit;
+                        run.refThreshold = refThreshold;
+                        execute(family, run);
+                        std::cerr << run.key() << ": " << run.status << ", PLA " << run.plaMs << "ms, " << run.peakRssKb << "KB" << std::endl;
+                        runs.push_back(run);
+                    }
+                }
+            }
+        }
+    }
+
+    std::ofstream file;
+    if (!outputPath.empty()) {
+        file.open(outputPath);
+        if (!file) {
+            throw std::invalid_argument("Could not write " + outputPath);
+        }
+    }
+    std::ostream& out = outputPath.empty() ? std::cout : file;
+    if (format == "json") {
+        writeJson(out, runs);
+    } else {
+        writeCsv(out, runs);
+    }
+
+    if (!baselinePath.empty()) {
+        size_t regressions = compare(runs, readBaseline(baselinePath));
+        std::cout << regressions << " regressions against " << baselinePath << std::endl;
+        return regressions == 0 ? 0 : 1;
+    }
+    return 0;
+}
@@ -10,9 +10,14 @@
 #include <storm-parsers/parser/PrismParser.h>
 
 #include <storm/storage/prism/Program.h>
+#include <storm/storage/SymbolicModelDescription.h>
 #include <storm/storage/jani/Property.h>
 
 #include <storm/modelchecker/results/CheckResult.h>
+#include <storm/modelchecker/results/ExplicitQuantitativeCheckResult.h>
+#include <storm/modelchecker/reachability/SparseDtmcEliminationModelChecker.h>
+#include <storm/modelchecker/prctl/SparseDtmcPrctlModelChecker.h>
+#include <storm/logic/Formulas.h>
 
 #include <storm-cli-utilities/cli.h>
 #include <storm-cli-utilities/model-handling.h>
@@ -22,6 +27,8 @@
 
 #include <storm/models/ModelBase.h>
 
+#include <storm/environment/Environment.h>
+
 #include <storm/utility/initialize.h>
 #include <storm/utility/Stopwatch.h>
 #include <storm/utility/macros.h>
@@ -61,614 +68,3551 @@
 #include <stdexcept>
 #include <sstream>
 #include <iomanip>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <deque>
+#include <queue>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "BatchFile.h"
+#include "BinaryModelCache.h"
+#include "BoxArray.h"
+#include "DrnParser.h"
+#include "LruCache.h"
+#include "Metric.h"
+#include "Monotonicity.h"
+#include "ParameterSpace.h"
+#include "RegionCache.h"
+#include "RegionStore.h"
+#include "RunReport.h"
+#include "WorkStealingPool.h"
 
-int numberOfRandom = 3;
-boost::optional <uint_fast64_t> depthLimit = boost::none;
-double refThreshold = 0.05;
-bool faster = false;
+/*!
+ * The options of a run, set from the user input by setOptions. They are passed to every function that needs them and
+ * are not changed during the run, so that several runs can be done at the same time on the same model.
+ */
+struct Options {
+    size_t numberOfRandom = 3;
+    boost::optional <uint_fast64_t> depthLimit = boost::none;
+    double refThreshold = 0.05;
+    bool faster = false;
+    bool incremental = false;
+    size_t numberOfThreads = 1;
+    bool exactSelection = true;
+    bool includeCenterSat = false;
+    double bestFirstTolerance = -1;
+    bool binaryCache = false;
+    std::string preprocessing = "";
+    //! The steps of preprocessing in the given order, set by setOptions
+    std::vector<std::string> preprocessingSteps;
+    bool solutionFunction = false;
+    std::string metricNorm = "L2";
+    std::string metricWeights = "";
+    std::string reportPath = "";
+    double timeBudget = -1;
+    double epsilonTolerance = -1;
+    size_t speculativeAttempts = 1;
+    bool monotonicity = false;
+    double sensitivity = -1;
+    size_t parseThreads = 0;
+    bool keepViolated = false;
+    double regionMemory = -1;
+    bool certify = false;
+    std::string cacheDirectory = "";
+    size_t numberOfSamples = 0;
+    std::string constants = "";
+    bool symbolic = false;
+    double regionCacheSize = 256;
+    //! The checksum of the model file, part of the key of the region cache, set if cacheDirectory is given
+    uint64_t modelChecksum = 0;
+    //! Set if several runs share the model at the same time, then the refinement of storm is not used (see specificationMutex)
+    bool concurrent = false;
+    //! Set for the fallback of certify, then the regions are checked in exact arithmetic by the refinement of storm
+    bool exactEngine = false;
+    //! The end of the time budget, set by startTimeBudget at the start of the run
+    std::chrono::steady_clock::time_point deadline;
+    //! Set by the epsilon search, so that doubling epsilon reaches the whole parameter space instead of failing
+    bool clipRegion = false;
+    //! Set for the rows of a batch, then the results of a row are not set in the run report, which only has the totals of the batch
+    bool batchRow = false;
+};
+
+//! Set by the epsilon search for the thread of a speculative PLA attempt, the attempt stops when it becomes true
+thread_local std::atomic<bool> const* attemptCancelled = nullptr;
+
+//! The polynomial cache of carl is shared by all threads, so parameter lifting checkers are specified one after the other
+std::mutex specificationMutex;
+
+//! The report of the current run, written to reportPath
+RunReport runReport;
+
+typedef std::vector<std::pair<storm::storage::ParameterRegion<storm::RationalFunction>, storm::modelchecker::RegionResult>> RegionResultVector;
+
+//! The monotonicity of every formula, nullptr for a formula that was not analyzed
+typedef std::vector<std::shared_ptr<const FormulaMonotonicity>> MonotonicityVector;
 
 /*!
- * Function to make string into double.
- *
- * @param str - String.
+ * The partition of the last region checked by PLA. It is kept between the retries in main, so that
+ * a retry with a bigger epsilon only has to refine the part of the new region that was not checked yet.
+ * The regions of the shell are added to the same store.
+ */
+struct PreviousPartition {
+    boost::optional<storm::storage::ParameterRegion<storm::RationalFunction>> region;
+    std::unique_ptr<RegionStore> store;
+};
+
+/*!
+ * The outcome of PLA, filled additionally to the printed output, so that it can be reported per query.
+ */
+struct PlaOutcome {
+    int status = 9;
+    bool centerSat = false;
+    double distance = -1;
+    double gap = -1;
+    //! If the time budget ran out before the refinement was finished
+    bool interrupted = false;
+    std::vector<std::pair<std::string, double>> instantiation;
+    //! The AllSat region the instantiation was selected from, empty if only the instantiation itself is checked
+    Box region;
+};
+
+/*!
+ * Starts the time budget of a run, if the user gave one.
  *
- * @return The double of the string.
+ * @param options - The options of the run, the deadline is set in them.
  */
-double stringToDouble(std::string str){
-    std::string::size_type positionOfNumerator = str.find("/");
-    if(positionOfNumerator == std::string::npos){ //if it is not a fraction just convert and return
-        return std::stod(str);
+void startTimeBudget(Options& options){
+    if(options.timeBudget >= 0){
+        options.deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(static_cast<int64_t>(options.timeBudget * 1e6));
     }
-    double lb = std::stod((str.substr(0,positionOfNumerator)));
-    double ub = std::stod((str.substr(positionOfNumerator + 1)));
+}
 
-    double res = (lb/ub);
+/*!
+ * Checks if the time budget of the run is used up. The refinement checks it between two regions, so a single region
+ * check is never interrupted.
+ *
+ * @param options - The options of the run.
+ *
+ * @return true, if there is a time budget and it is used up.
+ */
+bool budgetExhausted(Options const& options){
+    return options.timeBudget >= 0 && std::chrono::steady_clock::now() >= options.deadline;
+}
 
-    const double multiplier = std::pow(10.0, 3);
-    return std::ceil(res * multiplier) / multiplier; //return lb/ub; for not rounded
+/*!
+ * Checks if the current PLA attempt should stop, because the time budget is used up or the epsilon search cancelled it.
+ *
+ * @param options - The options of the run.
+ * @param cancelled - The cancellation flag of the attempt, may be nullptr.
+ *
+ * @return true, if the attempt should stop.
+ */
+bool attemptStopped(Options const& options, std::atomic<bool> const* cancelled){
+    return budgetExhausted(options) || (cancelled != nullptr && cancelled->load());
 }
 
 /*!
  * Helper - function to take the best value for a parameter.
  *
- * @param initial - The initial instantiation.
+ * @param initial - The initial value of the parameter.
  * @param lower - The lower bound.
  * @param upper - The upper bound.
  *
  * @return The new parameter value.
  */
-std::pair<std::string, double> calcNewBoundsForPar(std::pair<std::string, double> initial, double lower, double upper){
-    double take;
-    if((initial.second - upper) <= 0 && (initial.second - lower)>=0){
-        take = initial.second; //take the initial value if it is in the interval
-    }else if(abs(initial.second - upper) <= abs(initial.second - lower)){
-        take = upper;
-    }else{
-        take = lower;
+double calcNewBoundsForPar(double initial, double lower, double upper){
+    if((initial - upper) <= 0 && (initial - lower) >= 0){
+        return initial; //take the initial value if it is in the interval
+    }else if(std::abs(initial - upper) <= std::abs(initial - lower)){
+        return upper;
     }
-    return std::make_pair(initial.first, take);
+    return lower;
 }
 
 /*!
- * Helper - function to extract instantiation from region string.
+ * Function to extract the instantiation from a region, every parameter takes the value closest to the initial instantiation.
  *
- * @param par - The string of a single parameter.
- * @param initial - The initial instantiation, not always needed.
+ * @param box - The bounds of the region.
+ * @param initial - The initial instantiation.
  *
  * @return The instantiation.
  */
-std::pair<std::string, double> getInstantiationFromParBounds(std::string par, std::vector<std::pair<std::string, double>> initial = {{"", 0}}){
-    std::string res = "";
-    //!Get the position of the lower bound
-    std::string::size_type positionOfFirstRelation = par.find("<=");
-    STORM_LOG_THROW(positionOfFirstRelation!=std::string::npos, storm::exceptions::InvalidArgumentException, "When parsing the region" << par << " I could not find a '<=' after the first number");
-
-    //!Get the position of the upper bound
-    std::string::size_type positionOfSecondRelation = par.find("<=", positionOfFirstRelation+2);
-    STORM_LOG_THROW(positionOfSecondRelation!=std::string::npos, storm::exceptions::InvalidArgumentException, "When parsing the region" << par << " I could not find a '<=' after the parameter");
-
-    //!Get the parameter as string and the bounds as doubles
-    std::string parameter = par.substr(positionOfFirstRelation+2,positionOfSecondRelation-(positionOfFirstRelation+2));
-    parameter.erase(std::remove_if (parameter.begin(), parameter.end(), ::isspace), parameter.end());
-
-    double lb = stringToDouble((par.substr(0,positionOfFirstRelation)));
-    double ub = stringToDouble((par.substr(positionOfSecondRelation+2)));
-
-    std::vector<std::pair<std::string, double>> temp = {{"", 0}}; //todo do it with boolean, probably more simple
-    if(lb-ub != 0 && initial !=  temp){
-        std::pair<std::string, double> found = {"", 0};
-        std::pair<std::string, double> check = {"", 0};
-        for(auto const& inst: initial){
-            if(inst.first == parameter){
-                found = inst;
-                break;
-            }
-        }
-        if(check == found){
-            throw std::invalid_argument("Error in getInstantiationFromParBounds");
-        }
-        return calcNewBoundsForPar(found, lb, ub);
+Instantiation getInstantiationFromBox(Box const& box, Instantiation const& initial){
+    Instantiation res(initial.size());
+    for(size_t i = 0; i < initial.size(); i++){
+        res[i] = calcNewBoundsForPar(initial[i], box.lower[i], box.upper[i]);
     }
-
-    return std::make_pair(parameter, ub);
+    return res;
 }
 
 /*!
- * Function to extract instantiation from region string.
+ * Builds the region to give as an argument for the PLA.
  *
- * @param parameters - A string of the current parameter bounds.
- * @param region_string - The constant, that is used to change the bounds, calculated in calc_bound.
+ * @param space - The parameters of the model.
+ * @param initial - The initial values of the parameters, in most cases lb=ub.
+ * @param bound - The change of the bounds of every parameter, calculated in calc_bound.
+ * @param clip - If the region is clipped to the parameter space [0,1].
  *
- * @return The instantiation.
+ * @return The bounds of the region for the PLA algorithm.
  */
-std::vector<std::pair<std::string, double>> getInstantiationFromRegion(std::set<storm::RationalFunctionVariable> parameters , std::string region_string,  std::vector<std::pair<std::string, double>> initial = {{"", 0}}){
-    std::vector<std::pair<std::string, double>> res;
-    std::vector<std::string> parameterBoundaries;
-    boost::split(parameterBoundaries, region_string, boost::is_any_of(","));
-    for (auto const& parameter : parameterBoundaries){
-        if (!std::all_of(parameter.begin(),parameter.end(), ::isspace)){ //skip this string if it only consists of space
-            //!Appends to res the bounds of the parameter
-            res.push_back(getInstantiationFromParBounds(parameter, initial));
+Box build_region(ParameterSpace const& space, Box initial, std::vector<double> const& bound, bool clip = false){
+    for(size_t i = 0; i < space.size(); i++){
+        initial.lower[i] -= bound[i];
+        initial.upper[i] += bound[i];
+        if(clip){
+            initial.lower[i] = std::max(0.0, initial.lower[i]);
+            initial.upper[i] = std::min(1.0, initial.upper[i]);
         }
     }
-
-    return res;
+    std::cout << "Doing PLA on: "<< space.toString(initial) <<std::endl;
+    return initial;
 }
 
 /*!
- * Function to calculate the bounds of a single parameter, to later append to the region string.
+ * Builds the whole parameter space, every parameter between 0 and 1.
  *
- * @param par - A string of the current parameter bounds.
- * @param bound - The constant, that is used to change the bounds, calculated in calc_bound.
+ * @param space - The parameters of the model.
  *
- * @return String representing the new parameter bounds.
+ * @return The bounds of the region for the PLA algorithm.
  */
-std::string change_region(std::string par, double bound){
-    std::string res = "";
-    //!Get the position of the lower bound
-    std::string::size_type positionOfFirstRelation = par.find("<=");
-    STORM_LOG_THROW(positionOfFirstRelation!=std::string::npos, storm::exceptions::InvalidArgumentException, "When parsing the region" << par << " I could not find a '<=' after the first number");
-
-    //!Get the position of the upper bound
-    std::string::size_type positionOfSecondRelation = par.find("<=", positionOfFirstRelation+2);
-    STORM_LOG_THROW(positionOfSecondRelation!=std::string::npos, storm::exceptions::InvalidArgumentException, "When parsing the region" << par << " I could not find a '<=' after the parameter");
-
-    //!Get the parameter as string and the bounds as doubles
-    std::string parameter = par.substr(positionOfFirstRelation+2,positionOfSecondRelation-(positionOfFirstRelation+2));
-    parameter.erase(std::remove_if (parameter.begin(), parameter.end(), ::isspace), parameter.end());
-
-    double lb = std::stod((par.substr(0,positionOfFirstRelation)));
-    double ub = std::stod((par.substr(positionOfSecondRelation+2)));
-
-    //!Calculate the new bounds
-    lb = lb - bound;
-
-    ub = ub + bound;
-
-    //!Removes the trailing zeros of a double
-    std::ostringstream oss;
-    oss << std::setprecision(8) << std::noshowpoint << lb;
-    std::string str_lb = oss.str();
-    oss.str("");
-    oss << std::setprecision(8) << std::noshowpoint << ub;
-    std::string str_ub = oss.str();
-
-    //!Build the string as needed for a region, e.g. "0.1 <= p <= 0.9"
-    res.append(str_lb);
-    res.append("<=");
-    res.append(parameter);
-    res.append("<=");
-    res.append(str_ub);
-    res.append(",");
-
+Box build_parSpace(ParameterSpace const& space){
+    Box res;
+    res.lower.assign(space.size(), 0);
+    res.upper.assign(space.size(), 1);
+    std::cout << "Doing PLA on: "<< space.toString(res) <<std::endl;
     return res;
 }
 
 /*!
- * Builds the region to give as an argument for the PLA, using change_region.
+ * Checks if a region lies completely inside another region.
  *
- * @param parameters - The parameters of the model.
- * @param region_string - The initial values of the parameters, in most cases lb=ub, e.g. "0.5 <= p <= 0.5".
- * @param epsilon - The constant, that is used to change the bounds, calculated in calc_bound.
+ * @param inner - The region that should be contained.
+ * @param outer - The region that should contain the other one.
  *
- * @return The region string to use as an argument for the PLA algorithm.
+ * @return True if every parameter bound of inner lies within the bounds of outer.
  */
-std::string build_region(std::set<storm::RationalFunctionVariable> parameters , std::string region_string, double epsilon){
-    std::string res = "";
-    std::vector<std::string> parameterBoundaries;
-    boost::split(parameterBoundaries, region_string, boost::is_any_of(","));
-    for (auto const& parameter : parameterBoundaries){
-        if (!std::all_of(parameter.begin(),parameter.end(), ::isspace)){ //skip this string if it only consists of space
-            //!Appends to res the bounds of the parameter
-            res.append(change_region(parameter, epsilon));
+bool isContainedIn(storm::storage::ParameterRegion<storm::RationalFunction> const& inner, storm::storage::ParameterRegion<storm::RationalFunction> const& outer){
+    if(inner.getVariables() != outer.getVariables()){
+        return false;
+    }
+    for(auto const& var : outer.getVariables()){
+        if(inner.getLowerBoundary(var) < outer.getLowerBoundary(var) || outer.getUpperBoundary(var) < inner.getUpperBoundary(var)){
+            return false;
         }
     }
-    //!Removes the comma of the last parameter bounds
-    res.pop_back();
-
-    std::cout << "Doing PLA on: "<< res <<std::endl;
-    return res;
-}
-
-std::string change_parSpace(std::string par){
-    std::string res = "";
-    //!Get the position of the lower bound
-    std::string::size_type positionOfFirstRelation = par.find("<=");
-    STORM_LOG_THROW(positionOfFirstRelation!=std::string::npos, storm::exceptions::InvalidArgumentException, "When parsing the region" << par << " I could not find a '<=' after the first number");
-
-    //!Get the position of the upper bound
-    std::string::size_type positionOfSecondRelation = par.find("<=", positionOfFirstRelation+2);
-    STORM_LOG_THROW(positionOfSecondRelation!=std::string::npos, storm::exceptions::InvalidArgumentException, "When parsing the region" << par << " I could not find a '<=' after the parameter");
-
-    //!Get the parameter as string and the bounds as doubles
-    std::string parameter = par.substr(positionOfFirstRelation+2,positionOfSecondRelation-(positionOfFirstRelation+2));
-    parameter.erase(std::remove_if (parameter.begin(), parameter.end(), ::isspace), parameter.end());
-
-    //!Removes the trailing zeros of a double
-    std::ostringstream oss;
-    oss << std::setprecision(8) << std::noshowpoint << 0;
-    std::string str_lb = oss.str();
-    oss.str("");
-    oss << std::setprecision(8) << std::noshowpoint << 1;
-    std::string str_ub = oss.str();
-
-    //!Build the string as needed for a region, e.g. "0.1 <= p <= 0.9"
-    res.append(str_lb);
-    res.append("<=");
-    res.append(parameter);
-    res.append("<=");
-    res.append(str_ub);
-    res.append(",");
-
-    return res;
+    return true;
 }
 
-std::string build_parSpace (std::set<storm::RationalFunctionVariable> parameters , std::string region_string){
-    std::string res = "";
-    std::vector<std::string> parameterBoundaries;
-    boost::split(parameterBoundaries, region_string, boost::is_any_of(","));
-    for (auto const& parameter : parameterBoundaries){
-        if (!std::all_of(parameter.begin(),parameter.end(), ::isspace)){ //skip this string if it only consists of space
-            //!Appends to res the bounds of the parameter
-            res.append(change_parSpace(parameter));
+/*!
+ * Splits the part of the outer region, that is not covered by the inner region, into disjoint boxes.
+ * For every parameter there is at most one box below and one box above the inner region, so the shell consists of up to 2n boxes.
+ *
+ * @param inner - The region that was already checked, must be contained in outer.
+ * @param outer - The enlarged region.
+ *
+ * @return The boxes that together with the inner region cover the outer region.
+ */
+std::vector<storm::storage::ParameterRegion<storm::RationalFunction>> build_shell(storm::storage::ParameterRegion<storm::RationalFunction> const& inner, storm::storage::ParameterRegion<storm::RationalFunction> const& outer){
+    typedef storm::storage::ParameterRegion<storm::RationalFunction>::Valuation Valuation;
+    std::vector<storm::storage::ParameterRegion<storm::RationalFunction>> res;
+    Valuation lower = outer.getLowerBoundaries();
+    Valuation upper = outer.getUpperBoundaries();
+    for(auto const& var : outer.getVariables()){
+        //!The box below the inner region for this parameter
+        if(outer.getLowerBoundary(var) < inner.getLowerBoundary(var)){
+            Valuation boxUpper = upper;
+            boxUpper[var] = inner.getLowerBoundary(var);
+            res.emplace_back(lower, boxUpper);
+        }
+        //!The box above the inner region for this parameter
+        if(inner.getUpperBoundary(var) < outer.getUpperBoundary(var)){
+            Valuation boxLower = lower;
+            boxLower[var] = inner.getUpperBoundary(var);
+            res.emplace_back(boxLower, upper);
         }
+        //!The following boxes only span the inner bounds of this parameter, so they do not overlap the ones above
+        lower[var] = inner.getLowerBoundary(var);
+        upper[var] = inner.getUpperBoundary(var);
     }
-    //!Removes the comma of the last parameter bounds
-    res.pop_back();
-
-    std::cout << "Doing PLA on: "<< res <<std::endl;
     return res;
 }
 
 /*!
- * Calculates the distance between two parametric instantiations.
+ * Splits a region in the middle of a single parameter.
  *
- * @param inst_old - The old instantiation of the parameters.
- * @param inst_new - The new instantiation of the parameters.
- * @param param_number - The number of parameters in the model.
+ * @param region - The region to split.
+ * @param var - The parameter, whose bounds are halved.
  *
- * @return The EC-distance, with two decimal numbers.
+ * @return The lower and the upper half of the region.
  */
-double EC_dist(std::vector<std::pair<std::string, double>> oldInst, std::vector<std::pair<std::string, double>> newInst){
-    double temp = 0;
-    for (int i = 0; i < newInst.size(); i++){
-        for(int j = 0; j < newInst.size(); j++){
-            if(newInst[i].first == oldInst[j].first){
-                temp +=  std::pow((newInst[i].second - oldInst[j].second), 2); //(i_new - i_old)*(i_new - i_old)
-                break;
-            }
-        }
-    }
-    double distance = sqrt(temp);
-
-    //!Rounds the distance to 2 decimal places
-    const double multiplier = std::pow(10.0, 3);
-    return std::ceil(distance * multiplier) / multiplier; //return sqrt(temp); for not rounded
+std::vector<storm::storage::ParameterRegion<storm::RationalFunction>> bisect(storm::storage::ParameterRegion<storm::RationalFunction> const& region, storm::RationalFunctionVariable const& var){
+    typedef storm::storage::ParameterRegion<storm::RationalFunction>::Valuation Valuation;
+    auto middle = (region.getLowerBoundary(var) + region.getUpperBoundary(var)) / storm::utility::convertNumber<storm::RationalFunctionCoefficient>(2);
+    Valuation lowerHalf = region.getUpperBoundaries();
+    lowerHalf[var] = middle;
+    Valuation upperHalf = region.getLowerBoundaries();
+    upperHalf[var] = middle;
+    return {storm::storage::ParameterRegion<storm::RationalFunction>(region.getLowerBoundaries(), lowerHalf), storm::storage::ParameterRegion<storm::RationalFunction>(upperHalf, region.getUpperBoundaries())};
 }
 
 /*!
- * Calculates the constant to be used to change the parameter bounds in change_region.
+ * Splits the regions into smaller boxes, halving one parameter after the other, till there are enough boxes to keep all threads busy.
  *
- * @param epsilon - The initial value given by the user.
- * @param numberOfParameters - The number of parameters in the model.
+ * @param regions - The regions to split.
+ * @param minimalNumber - The minimal number of boxes.
  *
- * @return The rounded to two decimal places constant.
+ * @return The boxes, that together cover the regions.
  */
-double calc_bound(double epsilon, size_t numberOfParameters){
-    //!Checks if numberOfParameters can be safely casted to integer.
-    if ( numberOfParameters > INT_MAX ){
-        throw std::overflow_error("The number of parameters is to big" + numberOfParameters);
+std::vector<storm::storage::ParameterRegion<storm::RationalFunction>> split_regions(std::vector<storm::storage::ParameterRegion<storm::RationalFunction>> regions, size_t minimalNumber){
+    if(regions.empty()){
+        return regions;
     }
-    int parNumber = static_cast<int>(numberOfParameters);
-    double res = epsilon/(sqrt(parNumber));
-
-    //!Rounds to three decimal places
-    const double multiplier = std::pow(10.0, 3);
-    return std::ceil(res * multiplier) / multiplier; //return res; for not rounded
+    std::vector<storm::RationalFunctionVariable> variables(regions.front().getVariables().begin(), regions.front().getVariables().end());
+    size_t next = 0;
+    //!Splitting stops after every parameter was halved a few times, the remaining work is split by the refinement
+    while(regions.size() < minimalNumber && next < 4 * variables.size()){
+        std::vector<storm::storage::ParameterRegion<storm::RationalFunction>> halves;
+        for(auto const& region : regions){
+            auto parts = bisect(region, variables[next % variables.size()]);
+            halves.insert(halves.end(), parts.begin(), parts.end());
+        }
+        regions = halves;
+        next++;
+    }
+    return regions;
 }
 
 /*!
- * Gets a random region from the result vector of PLA, after only the satisfying regions are left.
+ * Computes the solution function of the formula at the initial state by state elimination.
  *
- * @param result_onlySAT - the vector with the satisfying regions.
+ * @param model - The model.
+ * @param formula - The formula, must be a probability operator formula with a bound.
  *
- * @return a random region-string.
+ * @return The probability of the path formula as a rational function of the parameters.
+ */
+storm::RationalFunction computeSolutionFunction(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model, storm::logic::Formula const& formula){
+    //!The function is computed for the formula without the bound
+    auto quantitative = std::make_shared<storm::logic::ProbabilityOperatorFormula>(formula.asOperatorFormula().getSubformula().asSharedPointer());
+    storm::Environment env;
+    storm::modelchecker::SparseDtmcEliminationModelChecker<storm::models::sparse::Dtmc<storm::RationalFunction>> checker(*model);
+    auto result = checker.check(env, storm::modelchecker::CheckTask<storm::logic::Formula, storm::RationalFunction>(*quantitative, true));
+    return result->asExplicitQuantitativeCheckResult<storm::RationalFunction>()[*model->getInitialStates().begin()];
+}
+
+/*!
+ * The monotonicity of a formula of a model. The model is kept, so that its address is not reused by another model.
  */
-std::string getRandomRegion(std::vector<std::pair<storm::storage::ParameterRegion<storm::RationalFunction>, storm::modelchecker::RegionResult>> result_onlySAT){
-    std::string region_string;
-    int random = rand() % result_onlySAT.size();
-    //! Get a random region
-    auto const& region = result_onlySAT[random];
+struct MonotonicityEntry {
+    std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model;
+    std::string formula;
+    std::shared_ptr<const FormulaMonotonicity> monotonicity;
+};
+
+//! The last monotonicity analyses, so that a formula is analyzed once per model, also across queries of the service
+std::mutex monotonicityMutex;
+std::deque<MonotonicityEntry> monotonicityCache;
 
-    //! Extract only the string of this region.
-    std::stringstream first;
-    first << region.first;
-    region_string = first.str();
-    return region_string;
+/*!
+ * Drops the monotonicity analyses of a model, e.g. when the service removes the model from its cache.
+ *
+ * @param model - The model.
+ */
+void dropMonotonicity(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> const& model){
+    std::lock_guard<std::mutex> lock(monotonicityMutex);
+    monotonicityCache.erase(std::remove_if(monotonicityCache.begin(), monotonicityCache.end(), [&](MonotonicityEntry const& entry){
+        return entry.model == model;
+    }), monotonicityCache.end());
 }
 
 /*!
- * Function of processing the CenterSat regions. It gets the center points of the regions and searches for the minimal one.
+ * Analyzes the monotonicity of every formula in every parameter, once per model and formula: the solution function is
+ * computed by state elimination and the signs of its partial derivatives are bounded on the whole parameter space
+ * (see FormulaMonotonicity). Only probability formulae with a bound are analyzed.
  *
- * @param result_exists - the vector with the CenterSat regions.
- * @param modelParameters - the parameters.
- * @param region_string - the initial instantiation, used for computing the distance.
+ * @param model - The model.
+ * @param formulae - The formulae.
+ * @param space - The parameters of the model.
  *
- * @return int - success 1 or failure 0.
+ * @return The monotonicity of every formula.
  */
-int processCenterSat(std::vector<std::pair<storm::storage::ParameterRegion<storm::RationalFunction>, storm::modelchecker::RegionResult>> result_exists, std::set<storm::RationalFunctionVariable> modelParameters, std::string region_string){
-    if(result_exists.size()< numberOfRandom){
-        std::cout << "There are only this much CenterSat regions:"<< result_exists.size() <<std::endl;
-        numberOfRandom = result_exists.size();
-    }
-    std::vector<std::pair<std::string, double>> initialInst = getInstantiationFromRegion(modelParameters, region_string);
-    std::vector<std::pair<std::string, double>> newInst;
-    double distanceMin = 5;
-    for (auto const& res : result_exists) {
-        //todo remove later
-        std::cout << res.second << ": " << res.first <<std::endl;
-
-        std::ostringstream tempor;
-        tempor << res.first.getCenterPoint();
-        std::string val = tempor.str();
-        val.erase(std::remove(val.begin(), val.end(), '{'), val.end());
-        val.erase(std::remove(val.begin(), val.end(), '}'), val.end());
-
-        std::vector<std::string> parameters;
-        boost::split(parameters, val, boost::is_any_of(","));
-        std::vector<std::pair<std::string, double>> candidate;
-
-        for(auto const& par : parameters ){
-            std::string::size_type positionOfFirstRelation = par.find(":");
-            STORM_LOG_THROW(positionOfFirstRelation !=std::string::npos, storm::exceptions::InvalidArgumentException, "When parsing the valuation" << par << " I could not find a '='.");
-
-            std::string parameter = par.substr(0, positionOfFirstRelation);
-            parameter.erase(std::remove_if(parameter.begin(), parameter.end(), ::isspace), parameter.end());
-
-            double value = stringToDouble((par.substr(positionOfFirstRelation + 1)));
-
-            candidate.push_back(std::make_pair(parameter, value));
+MonotonicityVector analyzeMonotonicity(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model, std::vector<std::shared_ptr<const storm::logic::Formula>> const& formulae, ParameterSpace const& space){
+    std::lock_guard<std::mutex> lock(monotonicityMutex);
+    MonotonicityVector res;
+    for(auto const& formula : formulae){
+        std::string key = formula->toString();
+        auto cached = std::find_if(monotonicityCache.begin(), monotonicityCache.end(), [&](MonotonicityEntry const& entry){
+            return entry.model == model && entry.formula == key;
+        });
+        if(cached != monotonicityCache.end()){
+            res.push_back(cached->monotonicity);
+            continue;
         }
 
-        double candDistance = EC_dist(initialInst, candidate);
-        if(candDistance < distanceMin){
-            newInst = candidate;
-            distanceMin = candDistance;
+        std::shared_ptr<const FormulaMonotonicity> monotonicity;
+        if(formula->isProbabilityOperatorFormula() && formula->asOperatorFormula().hasBound()){
+            storm::utility::Stopwatch monotonicityWatch(true);
+            try{
+                //! The solution function is added to the polynomial cache of carl, see specificationMutex
+                std::lock_guard<std::mutex> specificationLock(specificationMutex);
+                monotonicity = std::make_shared<const FormulaMonotonicity>(space, computeSolutionFunction(model, *formula), formula->asOperatorFormula().getComparisonType(),
+                                                                           formula->asOperatorFormula().getThresholdAs<storm::RationalFunctionCoefficient>());
+            }catch(std::exception const& e){
+                std::cout << "The monotonicity of " << key << " could not be analyzed: " << e.what() << std::endl;
+            }
+            monotonicityWatch.stop();
+            STORM_PRINT("Time for the monotonicity analysis: " << monotonicityWatch << ".\n\n");
+            runReport.addPhase("monotonicity", key, monotonicityWatch.getTimeInMilliseconds());
         }
-        numberOfRandom--;
-        if(numberOfRandom == 0){
-            break;
+        if(monotonicity){
+            std::cout << "Monotonicity of " << key << ":";
+            for(size_t i = 0; i < space.size(); i++){
+                Monotonicity m = monotonicity->get(i);
+                std::cout << " " << space.getName(i) << " " << (m == Monotonicity::Increasing ? "increasing" : (m == Monotonicity::Decreasing ? "decreasing" : (m == Monotonicity::Constant ? "constant" : "unknown")));
+            }
+            std::cout << std::endl;
+        }else{
+            std::cout << "The monotonicity of " << key << " is not used, only probability formulae with a bound are analyzed." << std::endl;
         }
-    }
-
-    std::cout << distanceMin << " That is the newfound distance ;D" <<std::endl; //TODO fix that later
 
-    //!Prints the instantation
-    for (auto const& temp : newInst) {
-        std::cout << temp.first << "= " << temp.second <<std::endl;
+        monotonicityCache.push_back(MonotonicityEntry{model, key, monotonicity});
+        if(monotonicityCache.size() > 16){
+            monotonicityCache.pop_front();
+        }
+        res.push_back(monotonicity);
     }
-
-    return 1;
+    return res;
 }
 
 /*!
- * Calculates the constant to be used to change the parameter bounds in change_region.
+ * Combines the monotonicity of the formulae.
  *
- * @param path_to_model - The path to the model file, given by the user.
- * @param property_string - The property for which PLA would be executed.
- * @param region_string - The initial values of the parameters, in most cases lb=ub, e.g. "0.5 <= p <= 0.5".
- * @param epsilon - The initial value given by the user.
- * @param depthLimit - How many times a region would be split by PLA before declared for Unknown.
- * @param refThreshold - How big percent of the region can be left undecided by PLA.
+ * @param monotonicity - The monotonicity of every formula.
+ * @param numberOfParameters - The number of parameters.
  *
- * @return A vector containing only the SAT regions after the use of PLA.
+ * @return For every parameter, how the satisfaction of all formulae changes with it.
  */
-int pla(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model, std::vector<std::shared_ptr<const storm::logic::Formula>> formulae, std::string region_string, double epsilon, bool flag = false) {
-     //auto model = storm::parser::DirectEncodingParser<storm::RationalFunction>::parseModel(path_to_model)->template as<storm::models::sparse::Dtmc<storm::RationalFunction>>();
-
-     //!Extract parameters
-     auto modelParameters = storm::models::sparse::getProbabilityParameters(*model);
-     auto rewParameters = storm::models::sparse::getRewardParameters(*model);
-     modelParameters.insert(rewParameters.begin(), rewParameters.end());
+std::vector<Monotonicity> combineMonotonicity(MonotonicityVector const& monotonicity, size_t numberOfParameters){
+    std::vector<Monotonicity> res(numberOfParameters, monotonicity.empty() ? Monotonicity::Unknown : Monotonicity::Constant);
+    for(auto const& formula : monotonicity){
+        for(size_t i = 0; i < numberOfParameters; i++){
+            Monotonicity m = formula ? formula->get(i) : Monotonicity::Unknown;
+            if(res[i] == Monotonicity::Constant){
+                res[i] = m;
+            }else if(m != Monotonicity::Constant && m != res[i]){
+                res[i] = Monotonicity::Unknown;
+            }
+        }
+    }
+    return res;
+}
 
-     std::cout << modelParameters << std::endl;
+/*!
+ * Restricts the region to the side of the initial instantiation, where the formulae are satisfied more: if raising a
+ * parameter never violates the formulae, a closest solution never lowers it, and vice versa.
+ * A parameter is not restricted, if its bounds would become equal.
+ *
+ * @param box - The region.
+ * @param initial - The initial instantiation.
+ * @param monotonicity - For every parameter, how the satisfaction of all formulae changes with it.
+ *
+ * @return The number of restricted parameters.
+ */
+size_t restrictToImprovingSide(Box& box, Instantiation const& initial, std::vector<Monotonicity> const& monotonicity){
+    size_t res = 0;
+    for(size_t i = 0; i < monotonicity.size(); i++){
+        if(monotonicity[i] == Monotonicity::Increasing && box.lower[i] < initial[i] && initial[i] < box.upper[i]){
+            box.lower[i] = initial[i];
+            res++;
+        }else if(monotonicity[i] == Monotonicity::Decreasing && box.lower[i] < initial[i] && initial[i] < box.upper[i]){
+            box.upper[i] = initial[i];
+            res++;
+        }
+    }
+    return res;
+}
 
-     //! Uses the parameters and epsilon to calculate the constant to change the region and builds the new region
-     std::string input;
-     if (flag) {
-        input = build_parSpace(modelParameters, region_string);
-     }else{
-         double bound = calc_bound(epsilon, modelParameters.size());
-         input = build_region(modelParameters, region_string, bound);
-     }
-     auto region = storm::api::parseRegions<storm::RationalFunction>(input, *model);
-    //! Preparations for Model Checker
-    auto regionSettings = storm::settings::getModule<storm::settings::modules::RegionSettings>();
-    auto engine = regionSettings.getRegionCheckEngine();
-    boost::optional <uint_fast64_t> optionalDepthLimit = depthLimit;
-    auto refinementThreshold = storm::utility::convertNumber<storm::RationalFunction>(refThreshold);
-    //! Not using monotonicity. Comment this if you wan to use later version of storm.
-    uint_fast64_t monThresh = 0;
-    storm::api::MonotonicitySetting monotonicitySettings = storm::api::MonotonicitySetting();
+/*!
+ * Moves a satisfying instantiation towards the initial one in every parameter, in which all formulae are monotone, up
+ * to the boundary of the satisfying instantiations. Along such a parameter the satisfying values form an interval, so
+ * the boundary is found by bisection. Every step is checked exactly on the solution functions.
+ *
+ * @param monotonicity - The monotonicity of every formula.
+ * @param initial - The initial instantiation.
+ * @param inst - The instantiation, moved if possible.
+ *
+ * @return true, if the instantiation was moved.
+ */
+bool pushToBound(MonotonicityVector const& monotonicity, Instantiation const& initial, Instantiation& inst){
+    std::vector<Monotonicity> combined = combineMonotonicity(monotonicity, inst.size());
+    if(std::all_of(combined.begin(), combined.end(), [](Monotonicity m){ return m == Monotonicity::Unknown; })){
+        return false;
+    }
+    auto satisfiesAll = [&monotonicity](Instantiation const& point){
+        std::vector<storm::RationalFunctionCoefficient> exact;
+        for(double value : point){
+            exact.push_back(storm::utility::convertNumber<storm::RationalFunctionCoefficient>(value));
+        }
+        for(auto const& formula : monotonicity){
+            auto res = formula->satisfies(exact);
+            if(!res || !res.get()){
+                return false;
+            }
+        }
+        return true;
+    };
+    //! The instantiation is only moved, if it is confirmed on the solution functions
+    if(!satisfiesAll(inst)){
+        return false;
+    }
 
-    storm::utility::Stopwatch PLAwatch(true);
-    try {
-        auto result = storm::api::checkAndRefineRegionWithSparseEngine<storm::RationalFunction>(
-                model, storm::api::createTask<storm::RationalFunction>(formulae[0], true), region.front(), engine,
-                refinementThreshold,
-                optionalDepthLimit, regionSettings.getHypothesis(), false);
+    bool moved = false;
+    for(size_t i = 0; i < inst.size(); i++){
+        if(combined[i] == Monotonicity::Unknown || inst[i] == initial[i]){
+            continue;
+        }
+        Instantiation candidate = inst;
+        candidate[i] = initial[i];
+        if(satisfiesAll(candidate)){
+            inst = candidate;
+            moved = true;
+            continue;
+        }
+        double satisfying = inst[i];
+        double violating = initial[i];
+        for(int step = 0; step < 40; step++){
+            candidate[i] = (satisfying + violating) / 2;
+            if(satisfiesAll(candidate)){
+                satisfying = candidate[i];
+            }else{
+                violating = candidate[i];
+            }
+        }
+        if(satisfying != inst[i]){
+            inst[i] = satisfying;
+            moved = true;
+        }
+    }
+    return moved;
+}
 
-    PLAwatch.stop();
-    STORM_PRINT("Time for PLA: " << PLAwatch << ".\n\n");
+/*!
+ * Prints and records the lifted checks saved by the monotonicity.
+ *
+ * @param saved - The number of region checks decided on the solution functions instead of by parameter lifting.
+ */
+void reportSavedChecks(uint64_t saved){
+    std::cout << "Monotonicity: " << saved << " lifted checks saved." << std::endl;
+    runReport.countSavedChecks(saved);
+}
 
-    //! Extract only the SAT regions
-    std::vector<std::pair<storm::storage::ParameterRegion<storm::RationalFunction>, storm::modelchecker::RegionResult>> result_onlySAT;
-     std::vector<std::pair<storm::storage::ParameterRegion<storm::RationalFunction>, storm::modelchecker::RegionResult>> result_exists;
-    for (auto const& res : result->getRegionResults()) {
-        if (res.second == storm::modelchecker::RegionResult::AllSat) {
-            result_onlySAT.push_back(res);
+/*!
+ * Parameter lifting checkers for a conjunction of formulae on the same regions. A region is AllSat only if it is AllSat
+ * for every formula and AllViolated as soon as one formula refutes it, then the remaining formulae are not checked.
+ * The formula that refuted the last region is checked first, as it likely refutes the neighbouring regions as well.
+ * If the monotonicity of a formula is known, a region is decided on its corners, if the formula is monotone in all
+ * parameters, and otherwise checked with the monotone parameters collapsed to their worst and best bounds.
+ */
+class ConjunctionChecker {
+public:
+    typedef storm::modelchecker::SparseDtmcParameterLiftingModelChecker<storm::models::sparse::Dtmc<storm::RationalFunction>, double> Checker;
+
+    /*!
+     * Specifies one checker per formula, one after the other (see specificationMutex).
+     *
+     * @param monotonicity - The monotonicity of every formula, may be empty.
+     */
+    void specify(storm::Environment const& env, std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model, std::vector<std::shared_ptr<const storm::logic::Formula>> const& formulae, MonotonicityVector const& monotonicity = MonotonicityVector()){
+        std::lock_guard<std::mutex> lock(specificationMutex);
+        for(size_t i = 0; i < formulae.size(); i++){
+            checkers.push_back(FormulaChecker{std::unique_ptr<Checker>(new Checker()), i < monotonicity.size() ? monotonicity[i] : nullptr});
+            checkers.back().checker->specify(env, model, storm::api::createTask<storm::RationalFunction>(formulae[i], true), false, false);
         }
     }
 
-    if(result_onlySAT.empty()) {
-        for (auto const &res: result->getRegionResults()) {
-            if (res.second == storm::modelchecker::RegionResult::CenterSat) {
-                result_exists.push_back(res);
+    /*!
+     * @return AllViolated if one formula is AllViolated, AllSat if all are AllSat, CenterSat if the center point
+     *         satisfies all formulae, CenterViolated if it violates one and Unknown if that is not known.
+     */
+    storm::modelchecker::RegionResult analyzeRegion(storm::Environment const& env, storm::storage::ParameterRegion<storm::RationalFunction> const& region, storm::modelchecker::RegionResultHypothesis hypothesis){
+        bool allSat = true;
+        bool centerSat = true;
+        bool centerKnown = true;
+        for(size_t i = 0; i < checkers.size(); i++){
+            auto res = analyzeFormula(env, checkers[i], region, hypothesis);
+            if(res == storm::modelchecker::RegionResult::AllViolated){
+                std::rotate(checkers.begin(), checkers.begin() + i, checkers.begin() + i + 1);
+                return res;
             }
-        }
-		if(result_exists.empty()){
-            if(flag){
-                return 23;
+            allSat = allSat && res == storm::modelchecker::RegionResult::AllSat;
+            if(res == storm::modelchecker::RegionResult::Unknown){
+                centerKnown = false;
+            }else{
+                centerSat = centerSat && (res == storm::modelchecker::RegionResult::AllSat || res == storm::modelchecker::RegionResult::CenterSat);
             }
-			return 9;
-		}
-        return processCenterSat(result_exists, modelParameters, region_string);
+        }
+        if(allSat){
+            return storm::modelchecker::RegionResult::AllSat;
+        }
+        if(!centerSat){
+            return storm::modelchecker::RegionResult::CenterViolated;
+        }
+        return centerKnown ? storm::modelchecker::RegionResult::CenterSat : storm::modelchecker::RegionResult::Unknown;
     }
 
-    if(result_onlySAT.empty() && result_exists.empty()){
-        std::cout << "No feasible solution found for this arguments. Try again." <<std::endl;
-        return 9;
+    /*!
+     * @return The number of regions decided on the corners instead of by parameter lifting.
+     */
+    uint64_t getSavedChecks() const {
+        return savedChecks;
     }
 
-    if(result_onlySAT.size()< numberOfRandom){
-        std::cout << "There are only this much AllSatregions:"<< result_onlySAT.size() <<std::endl;
-        numberOfRandom = result_onlySAT.size();
+    void resetSavedChecks() {
+        savedChecks = 0;
     }
 
-    std::string reg = getRandomRegion(result_onlySAT);
-    //result_onlySAT.remove_if(result_onlySAT.begin(),result_onlySAT.end(), isUsed(result_onlySAT));
-
-    std::vector<std::pair<std::string, double>> initialInst = getInstantiationFromRegion(modelParameters, region_string);
-
-    std::vector<std::pair<std::string, double>> newInst = getInstantiationFromRegion(modelParameters, reg, initialInst);
-
-    double distanceMin = EC_dist(initialInst, newInst);
-
-    while((numberOfRandom-1) > 0){
-        if(result_onlySAT.empty()){
-            //Should not happen because of the above check, but put it just to be sure
-            std::cout << "The result vector is empty, yet you still try to get elements from it!" <<std::endl;
-            break;
+private:
+    struct FormulaChecker {
+        std::unique_ptr<Checker> checker;
+        std::shared_ptr<const FormulaMonotonicity> monotonicity;
+    };
+
+    storm::modelchecker::RegionResult analyzeFormula(storm::Environment const& env, FormulaChecker& formula, storm::storage::ParameterRegion<storm::RationalFunction> const& region, storm::modelchecker::RegionResultHypothesis hypothesis){
+        auto const& monotonicity = formula.monotonicity;
+        if(monotonicity && monotonicity->allMonotone()){
+            auto res = monotonicity->decide(region);
+            if(res != storm::modelchecker::RegionResult::Unknown){
+                savedChecks++;
+                return res;
+            }
         }
-        std::string newReg = getRandomRegion(result_onlySAT);
-        std::vector<std::pair<std::string, double>> candidate = getInstantiationFromRegion(modelParameters, newReg, initialInst);
-        double candDistance = EC_dist(initialInst, candidate);
-        if(candDistance < distanceMin){
-            newInst = candidate;
-            distanceMin = candDistance;
+        if(!monotonicity || monotonicity->numberOfMonotone() == 0 || monotonicity->allMonotone()){
+            return formula.checker->analyzeRegion(env, region, hypothesis, storm::modelchecker::RegionResult::Unknown, false);
+        }
+        //! The center of the region is better than the center of the worst face and worse than the one of the best face
+        auto worst = formula.checker->analyzeRegion(env, monotonicity->collapse(region, true), hypothesis, storm::modelchecker::RegionResult::Unknown, false);
+        if(worst == storm::modelchecker::RegionResult::AllSat || worst == storm::modelchecker::RegionResult::CenterSat){
+            return worst;
         }
-        numberOfRandom--;
+        auto best = formula.checker->analyzeRegion(env, monotonicity->collapse(region, false), hypothesis, storm::modelchecker::RegionResult::Unknown, false);
+        if(best == storm::modelchecker::RegionResult::AllViolated || best == storm::modelchecker::RegionResult::CenterViolated){
+            return best;
+        }
+        return storm::modelchecker::RegionResult::Unknown;
     }
 
+    std::vector<FormulaChecker> checkers;
+    uint64_t savedChecks = 0;
+};
 
-    std::cout << distanceMin << " The EC - distance between the original and new instantiation:" <<std::endl; 
+/*!
+ * Specified checkers that are not in use, so that a checker is specified once per model and formulae and reused by all
+ * PLA calls of a run, across the retries with a bigger epsilon and also across queries of the service. Specifying a
+ * checker analyses the graph of the model and builds the parameter lifting structures, which costs about as much as
+ * checking a few regions. A checker is used by one thread at a time, it is taken with acquire and given back with release.
+ * The model is kept, so that its address is not reused by another model.
+ */
+template<typename Checker>
+class CheckerPool {
+public:
+    /*!
+     * Takes an idle checker or specifies a new one.
+     *
+     * @param model - The model.
+     * @param key - The formulae and everything else the checker was specified for.
+     * @param specify - Specifies a new checker.
+     *
+     * @return The checker.
+     */
+    std::unique_ptr<Checker> acquire(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> const& model, std::string const& key, std::function<void(Checker&)> const& specify){
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto entry = find(model, key);
+            if(entry != entries.end()){
+                //! The entries are ordered by their last use
+                std::rotate(entry, entry + 1, entries.end());
+                if(!entries.back().idle.empty()){
+                    std::unique_ptr<Checker> res = std::move(entries.back().idle.back());
+                    entries.back().idle.pop_back();
+                    return res;
+                }
+            }
+        }
+        storm::utility::Stopwatch setupWatch(true);
+        std::unique_ptr<Checker> res(new Checker());
+        specify(*res);
+        setupWatch.stop();
+        STORM_PRINT("Time for specifying the checker: " << setupWatch << ".\n\n");
+        runReport.addPhase("checkerSetup", key, setupWatch.getTimeInMilliseconds());
+        return res;
+    }
 
-    //!Prints the instantation
-    for (auto const& temp : newInst) {
-        std::cout << temp.first << "= " << temp.second <<std::endl;
+    /*!
+     * Gives a checker back, so that it can be reused.
+     *
+     * @param model - The model.
+     * @param key - The key given to acquire.
+     * @param checker - The checker.
+     */
+    void release(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> const& model, std::string const& key, std::unique_ptr<Checker> checker){
+        std::lock_guard<std::mutex> lock(mutex);
+        auto entry = find(model, key);
+        if(entry == entries.end()){
+            //! The checkers of the model used the longest time ago are dropped
+            if(entries.size() >= 4){
+                entries.pop_front();
+            }
+            entries.push_back(Entry{model, key, {}});
+            entry = entries.end() - 1;
+        }
+        entry->idle.push_back(std::move(checker));
     }
 
-    }catch(storm::exceptions::InvalidArgumentException e){
-        throw std::invalid_argument("Epsilon is to big and the bounded region is making the transition matrix non-stochastic. Please choose smaller epsilon or change initial values.");
+    /*!
+     * Drops the idle checkers of a model, e.g. when the service removes the model from its cache.
+     *
+     * @param model - The model.
+     */
+    void drop(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> const& model){
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [&](Entry const& entry){
+            return entry.model == model;
+        }), entries.end());
     }
 
-    return 1;
-}
+private:
+    struct Entry {
+        std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model;
+        std::string key;
+        std::vector<std::unique_ptr<Checker>> idle;
+    };
+
+    typename std::deque<Entry>::iterator find(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> const& model, std::string const& key){
+        return std::find_if(entries.begin(), entries.end(), [&](Entry const& entry){
+            return entry.model == model && entry.key == key;
+        });
+    }
+
+    std::mutex mutex;
+    std::deque<Entry> entries;
+};
+
+typedef storm::modelchecker::SparseDtmcParameterLiftingModelChecker<storm::models::sparse::Dtmc<storm::RationalFunction>, double> LiftingChecker;
+
+//! The checkers of the refinement of this tool and the checkers of the refinement of storm
+CheckerPool<ConjunctionChecker> conjunctionCheckers;
+CheckerPool<LiftingChecker> liftingCheckers;
 
 /*!
- * Sets the options from the user input.
+ * @param formulae - The formulae.
+ * @param monotonicity - The monotonicity of every formula, may be empty.
  *
- * @param argc - The number of arguments given by the user.
- * @param argv - The arguments given by the user.
+ * @return The key of the checkers of the formulae in the CheckerPool.
  */
-void setOptions(int argc ,char *argv[]){
-     for(int i = 5; i < argc; i++) {
-         if (std::string(argv[i]) == "--numberOfRandom") {
-             numberOfRandom = std::stoi(std::string(argv[i+1]) );
-             std::cout << "Number of random instantiations: " << argv[i + 1] << endl;
-         } else if (std::string(argv[i])  == "--depthLimit") {
-             depthLimit = std::stoi(std::string(argv[i+1]));
-             std::cout << "Depth limit: " << argv[i + 1] << endl;
-         } else if (std::string(argv[i])  == "--refThreshold") {
-             refThreshold = std::stod(std::string(argv[i+1]));
-             if(refThreshold <= 0 || refThreshold >= 1){
-                 std::cout << "Please, choose a suitable value for refThreshold in (0,1)." << endl;
-             }
-             std::cout << "Refinement threshold: " << argv[i + 1] << endl;
-         } else if (std::string(argv[i])  == "--faster") {
-             faster = true;
-             std::cout << "Faster computation: " << argv[i + 1] << endl;
-         }else{
-             if(i%2 == 1){
-                 std::cout << "There is no such option: " << argv[i] << endl;
-             }
-         }
-     }
- }
+std::string checkerKey(std::vector<std::shared_ptr<const storm::logic::Formula>> const& formulae, MonotonicityVector const& monotonicity){
+    std::string res;
+    for(auto const& formula : formulae){
+        res += formula->toString() + "\n";
+    }
+    return monotonicity.empty() ? res : res + "monotonicity";
+}
 
 /*!
- * Checks if the arguments are correct to start the algorithm.
+ * Takes a ConjunctionChecker of the model and formulae from the pool, see CheckerPool.
  *
- * @param argc - The number of arguments given by the user.
- * @param argv - The arguments given by the user.
+ * @param model - The model.
+ * @param formulae - The formulae.
+ * @param monotonicity - The monotonicity of every formula, may be empty.
+ *
+ * @return The checker, to be given back with releaseChecker.
  */
-void check_argv(int argc ,char *argv[]){
-    std::ifstream test(argv[1]);
-    if (!test){
-        std::cout << argv[1]  << "is not a valid path/file." << endl;
-        throw std::invalid_argument("");
-    }
-    std::cout << "Region: " << argv[3]  << endl;
-    std::cout << "Epsilon: " << argv[4]  << endl;
-    if(argc > 5){
-        setOptions(argc, argv);
-    }
+std::unique_ptr<ConjunctionChecker> acquireChecker(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model, std::vector<std::shared_ptr<const storm::logic::Formula>> const& formulae, MonotonicityVector const& monotonicity){
+    auto res = conjunctionCheckers.acquire(model, checkerKey(formulae, monotonicity), [&](ConjunctionChecker& checker){
+        checker.specify(storm::Environment(), model, formulae, monotonicity);
+    });
+    res->resetSavedChecks();
+    return res;
 }
 
 /*!
- * argv[1] - file of the model
- * argv[2] - file of PCTL formula
- * argv[3] - instantiation in form of a region, e.g. "0.5 <= p <=0.5, 0.5 <= q <=0.5"
- * argv[4] - epsilon
+ * Gives a ConjunctionChecker back to the pool.
  */
-int main(int argc, char *argv[]) {
-    //! Check number of arguments
-    if(argc < 5){
-        throw std::invalid_argument("The following arguments are obligatory: model, pctl, region's string and epsilon!");
-    }
-    //! Check if the arguments are correct
-    check_argv(argc,argv);
-
-    //! Init loggers.
-    storm::utility::setUp();
-    //! Init settings.
-    storm::settings::initializeParsSettings("Storm-pars", "storm-pars");
+void releaseChecker(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model, std::vector<std::shared_ptr<const storm::logic::Formula>> const& formulae, MonotonicityVector const& monotonicity, std::unique_ptr<ConjunctionChecker> checker){
+    conjunctionCheckers.release(model, checkerKey(formulae, monotonicity), std::move(checker));
+}
 
-    storm::utility::Stopwatch totalTimer(true);
+/*!
+ * A region that still has to be analyzed by parallelRefinement, with the number of times it was split.
+ */
+struct RefinementTask {
+    storm::storage::ParameterRegion<storm::RationalFunction> region;
+    uint_fast64_t depth;
+};
+
+/*!
+ * Checks and refines the regions on numberOfThreads threads with a separate parameter lifting checker per thread.
+ * Like the sequential refinement of storm, a region is split at its center until it is decided, depthLimit is reached
+ * or at most refThreshold of the whole area is left undecided. When the time budget runs out or the attempt is cancelled,
+ * the remaining regions are left Unknown.
+ *
+ * @param model - The model.
+ * @param formulae - The formulae to check, a region is AllSat if it satisfies all of them.
+ * @param space - The parameters.
+ * @param regions - The regions to check.
+ * @param hypothesis - The hypothesis of the region settings.
+ * @param monotonicity - The monotonicity of every formula, may be empty.
+ * @param options - The options of the run.
+ * @param store - The region results of all threads are added to it as soon as they are known.
+ * @param cache - If given, regions covered by it are decided without a check and the decided regions are added to it.
+ */
+void parallelRefinement(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model, std::vector<std::shared_ptr<const storm::logic::Formula>> const& formulae, ParameterSpace const& space, std::vector<storm::storage::ParameterRegion<storm::RationalFunction>> const& regions, storm::modelchecker::RegionResultHypothesis hypothesis, MonotonicityVector const& monotonicity, Options const& options, RegionStore& store, RegionCache* cache = nullptr){
+    double totalArea = 0;
+    for(auto const& region : regions){
+        totalArea += storm::utility::convertNumber<double>(region.area());
+    }
+    double undecidedArea = totalArea;
+    std::mutex areaMutex;
+    //! The workers run on other threads, so the cancellation flag of the calling thread is passed on
+    std::atomic<bool> const* cancelled = attemptCancelled;
+    std::atomic<uint64_t> fromCache(0);
+
+    WorkStealingPool<RefinementTask> pool(options.numberOfThreads);
+    std::vector<std::unique_ptr<ConjunctionChecker>> checkers(pool.getNumberOfThreads());
+
+    std::vector<RefinementTask> initial;
+    for(auto const& region : split_regions(regions, 4 * pool.getNumberOfThreads())){
+        initial.push_back(RefinementTask{region, 0});
+    }
+
+    pool.run(initial, [&](size_t worker, RefinementTask& current, WorkStealingPool<RefinementTask>::Spawn const& spawn){
+        storm::Environment env;
+        if(!checkers[worker]){
+            checkers[worker] = acquireChecker(model, formulae, monotonicity);
+        }
+        {
+            std::lock_guard<std::mutex> lock(areaMutex);
+            if(undecidedArea <= options.refThreshold * totalArea || attemptStopped(options, cancelled)){
+                store.add(space.toBox(current.region), storm::modelchecker::RegionResult::Unknown);
+                return;
+            }
+        }
+
+        std::vector<std::pair<Box, storm::modelchecker::RegionResult>> pieces;
+        if(cache != nullptr && cache->cover(space.toBox(current.region), pieces)){
+            fromCache++;
+            std::lock_guard<std::mutex> lock(areaMutex);
+            undecidedArea -= storm::utility::convertNumber<double>(current.region.area());
+            for(auto const& piece : pieces){
+                store.add(piece.first, piece.second);
+            }
+            return;
+        }
+
+        auto res = checkers[worker]->analyzeRegion(env, current.region, hypothesis);
+        runReport.countChecked(1);
+        if(res == storm::modelchecker::RegionResult::AllSat || res == storm::modelchecker::RegionResult::AllViolated){
+            if(cache != nullptr){
+                cache->add(space.toBox(current.region), res);
+            }
+            std::lock_guard<std::mutex> lock(areaMutex);
+            undecidedArea -= storm::utility::convertNumber<double>(current.region.area());
+            store.add(space.toBox(current.region), res);
+        }else if(!options.depthLimit || current.depth < options.depthLimit.get()){
+            std::vector<storm::storage::ParameterRegion<storm::RationalFunction>> subRegions;
+            current.region.split(current.region.getCenterPoint(), subRegions);
+            runReport.countSplits(current.depth);
+            for(auto const& subRegion : subRegions){
+                spawn(RefinementTask{subRegion, current.depth + 1});
+            }
+        }else{
+            store.add(space.toBox(current.region), res);
+        }
+    });
+
+    if(!monotonicity.empty()){
+        uint64_t saved = 0;
+        for(auto const& checker : checkers){
+            saved += checker ? checker->getSavedChecks() : 0;
+        }
+        reportSavedChecks(saved);
+    }
+    for(auto& checker : checkers){
+        if(checker){
+            releaseChecker(model, formulae, monotonicity, std::move(checker));
+        }
+    }
+    if(cache != nullptr){
+        std::cout << "Region cache: " << fromCache << " regions decided by the " << cache->size() << " cached regions." << std::endl;
+        runReport.countRegions("fromCache", fromCache);
+    }
+}
+
+/*!
+ * Builds the metric chosen by the user for the parameters of the model.
+ *
+ * @param space - The parameters.
+ * @param options - The options of the run.
+ *
+ * @return The metric, the weights of the parameters not given in metricWeights are 1.
+ */
+Metric buildMetric(ParameterSpace const& space, Options const& options){
+    std::vector<double> weights;
+    if(!options.metricWeights.empty()){
+        weights.assign(space.size(), 1.0);
+        std::vector<std::string> entries;
+        boost::split(entries, options.metricWeights, boost::is_any_of(","));
+        for(auto const& entry : entries){
+            std::string::size_type positionOfEquals = entry.find("=");
+            if(positionOfEquals == std::string::npos){
+                throw std::invalid_argument("The weight " + entry + " is not of the form parameter=weight.");
+            }
+            std::string parameter = entry.substr(0, positionOfEquals);
+            parameter.erase(std::remove_if(parameter.begin(), parameter.end(), ::isspace), parameter.end());
+            weights[space.getIndex(parameter)] = stringToDouble(entry.substr(positionOfEquals + 1));
+        }
+    }
+    return Metric(Metric::parseNorm(options.metricNorm), weights);
+}
+
+/*!
+ * Calculates how much the bounds of every parameter are changed in build_region, so that the region lies within epsilon
+ * of the initial instantiation in the metric.
+ *
+ * @param epsilon - The initial value given by the user.
+ * @param metric - The metric.
+ * @param numberOfParameters - The number of parameters in the model.
+ *
+ * @return The change of the bounds of every parameter, rounded up to three decimal places.
+ */
+std::vector<double> calc_bound(double epsilon, Metric const& metric, size_t numberOfParameters){
+    std::vector<double> res;
+    //!Rounds to three decimal places
+    const double multiplier = std::pow(10.0, 3);
+    for(size_t i = 0; i < numberOfParameters; i++){
+        res.push_back(std::ceil(metric.radius(epsilon, i, numberOfParameters) * multiplier) / multiplier);
+    }
+    return res;
+}
+
+/*!
+ * Prints how many regions PLA found of every verdict and adds them to the run report.
+ *
+ * @param store - The regions and their verdicts.
+ */
+void printRegionCounts(RegionStore const& store){
+    uint64_t allSat = store.count(storm::modelchecker::RegionResult::AllSat);
+    uint64_t allViolated = store.count(storm::modelchecker::RegionResult::AllViolated);
+    uint64_t centerSat = store.count(storm::modelchecker::RegionResult::CenterSat);
+    uint64_t centerViolated = store.count(storm::modelchecker::RegionResult::CenterViolated);
+    uint64_t unknown = store.total() - allSat - allViolated - centerSat - centerViolated;
+    std::cout << "Regions: " << allSat << " AllSat, " << allViolated << " AllViolated, " << centerSat << " CenterSat, " << centerViolated << " CenterViolated, "
+              << unknown << " Unknown." << std::endl;
+    if(store.spilled() > 0){
+        std::cout << store.spilled() << " of " << store.size() << " stored regions were moved to a temporary file." << std::endl;
+    }
+    runReport.countRegions("AllSat", allSat);
+    runReport.countRegions("AllViolated", allViolated);
+    runReport.countRegions("CenterSat", centerSat);
+    runReport.countRegions("CenterViolated", centerViolated);
+    runReport.countRegions("Unknown", unknown);
+}
+
+/*!
+ * Adds the regions checked and split by the refinement of storm to the run report. Storm does not report them, so they
+ * are reconstructed from the partition: a region is split at its center into two parts along every parameter with a
+ * positive width, so the depth of a part follows from its width and every 2^k parts of one depth come from one split.
+ * The counts are marked as estimated in the report.
+ *
+ * @param space - The parameters.
+ * @param root - The refined region.
+ * @param regionResults - The partition of the refined region.
+ */
+void countRefinement(ParameterSpace const& space, storm::storage::ParameterRegion<storm::RationalFunction> const& root, RegionResultVector const& regionResults){
+    runReport.markEstimated();
+    Box rootBox = space.toBox(root);
+    size_t dimension = space.size();
+    size_t widest = 0;
+    size_t splitParameters = 0;
+    for(size_t i = 0; i < dimension; i++){
+        if(rootBox.upper[i] - rootBox.lower[i] > 0){
+            splitParameters++;
+        }
+        if(rootBox.upper[i] - rootBox.lower[i] > rootBox.upper[widest] - rootBox.lower[widest]){
+            widest = i;
+        }
+    }
+    if(splitParameters == 0 || regionResults.empty()){
+        runReport.countChecked(regionResults.size());
+        return;
+    }
+
+    std::vector<uint64_t> nodes;
+    for(auto const& res : regionResults){
+        Box box = space.toBox(res.first);
+        double ratio = (rootBox.upper[widest] - rootBox.lower[widest]) / std::max(box.upper[widest] - box.lower[widest], 1e-300);
+        size_t depth = static_cast<size_t>(std::max(0.0, std::round(std::log2(ratio))));
+        if(nodes.size() <= depth){
+            nodes.resize(depth + 1, 0);
+        }
+        nodes[depth]++;
+    }
+    uint64_t const children = uint64_t(1) << std::min<size_t>(splitParameters, 63);
+    uint64_t checked = nodes.back();
+    for(size_t depth = nodes.size() - 1; depth > 0; depth--){
+        uint64_t splits = (nodes[depth] + children - 1) / children;
+        runReport.countSplits(depth - 1, splits);
+        nodes[depth - 1] += splits;
+        checked += nodes[depth - 1];
+    }
+    runReport.countChecked(checked);
+}
+
+/*!
+ * Gets a random region of the satisfying regions of PLA.
+ *
+ * @param numberOfRegions - the number of satisfying regions.
+ *
+ * @return the index of a random region among the satisfying regions.
+ */
+uint64_t getRandomRegion(uint64_t numberOfRegions){
+    return rand() % numberOfRegions;
+}
+
+/*!
+ * Prints the new instantiation and stores it in the outcome.
+ *
+ * @param space - The parameters.
+ * @param newInst - The new instantiation.
+ * @param distance - The distance to the initial instantiation.
+ * @param centerSat - If the instantiation is only known to satisfy the property, not a whole region around it.
+ * @param outcome - If given, the instantiation is stored there.
+ * @param region - The AllSat region the instantiation was selected from, empty if centerSat is set.
+ */
+void reportInstantiation(ParameterSpace const& space, Instantiation const& newInst, double distance, bool centerSat, PlaOutcome* outcome, Box const& region = Box()){
+    //!Prints the instantation
+    for (size_t i = 0; i < space.size(); i++) {
+        std::cout << space.getName(i) << "= " << newInst[i] <<std::endl;
+    }
+
+    if(outcome != nullptr){
+        outcome->status = 1;
+        outcome->centerSat = centerSat;
+        outcome->distance = distance;
+        outcome->instantiation = space.toNamed(newInst);
+        outcome->region = region;
+    }
+}
+
+/*!
+ * Prints a candidate instantiation as soon as it is found, so that a caller with a time budget can use it before the
+ * refinement is finished. The line has the form "Candidate: <distance> <AllSat|CenterSat> p=0.5,q=0.3".
+ *
+ * @param space - The parameters.
+ * @param candidate - The instantiation.
+ * @param distance - The distance to the initial instantiation.
+ * @param centerSat - If only the instantiation itself is checked, not a whole region around it.
+ */
+void streamCandidate(ParameterSpace const& space, Instantiation const& candidate, double distance, bool centerSat){
+    std::cout << "Candidate: " << distance << " " << (centerSat ? "CenterSat" : "AllSat") << " ";
+    for(size_t i = 0; i < space.size(); i++){
+        std::cout << (i == 0 ? "" : ",") << space.getName(i) << "=" << candidate[i];
+    }
+    std::cout << std::endl;
+}
+
+/*!
+ * Function of processing the CenterSat regions. It gets the center points of the regions and searches for the minimal one.
+ *
+ * @param store - the regions of PLA, only the CenterSat regions are used.
+ * @param space - the parameters.
+ * @param initialInst - the initial instantiation, used for computing the distance.
+ * @param metric - the metric of the distance.
+ * @param options - the options of the run.
+ * @param outcome - if given, the found instantiation is stored there.
+ *
+ * @return int - success 1 or failure 0.
+ */
+int processCenterSat(RegionStore const& store, ParameterSpace const& space, Instantiation const& initialInst, Metric const& metric, Options const& options, PlaOutcome* outcome = nullptr){
+    //! A copy, so that the option is the same for the next call
+    size_t remaining = options.numberOfRandom;
+    uint64_t numberOfCenterSat = store.count(storm::modelchecker::RegionResult::CenterSat);
+    if(numberOfCenterSat < remaining){
+        std::cout << "There are only this much CenterSat regions:"<< numberOfCenterSat <<std::endl;
+        remaining = numberOfCenterSat;
+    }
+    Instantiation newInst;
+    double distanceMin = std::numeric_limits<double>::infinity();
+    bool done = false;
+    store.forEachBlock([&](RegionStore::Block const& block){
+        for(size_t i = 0; i < block.size && !done; i++){
+            if(block.verdict(i) != storm::modelchecker::RegionResult::CenterSat){
+                continue;
+            }
+            //todo remove later
+            std::cout << block.verdict(i) << ": " << space.toString(block.box(i)) <<std::endl;
+
+            Instantiation candidate(space.size());
+            for(size_t d = 0; d < space.size(); d++){
+                candidate[d] = (block.lower(i)[d] + block.upper(i)[d]) / 2;
+            }
+            double candDistance = metric.distance(initialInst, candidate);
+            if(candDistance < distanceMin){
+                newInst = candidate;
+                distanceMin = candDistance;
+            }
+            remaining--;
+            done = remaining == 0;
+        }
+    });
+
+    std::cout << distanceMin << " The " << metric.getName() << " - distance between the original and new instantiation:" <<std::endl;
+
+    reportInstantiation(space, newInst, distanceMin, true, outcome);
+    return 1;
+}
+
+/*!
+ * Finds the instantiation closest to the initial one among all given regions. The initial instantiation is projected onto
+ * every AllSat region, which gives the closest point of the region. Of a CenterSat region only the center point is known
+ * to satisfy the property, so it is used as a region of size zero. The store is searched block by block, so the regions
+ * moved to the temporary file are read once.
+ *
+ * @param store - The regions of PLA.
+ * @param verdicts - The verdicts of the candidates, AllSat and/or CenterSat.
+ * @param space - The parameters.
+ * @param initialInst - The initial instantiation, used for computing the distance.
+ * @param metric - The metric of the distance.
+ * @param monotonicity - The monotonicity of every formula, if known the found instantiation is moved to the boundary (see pushToBound).
+ * @param outcome - If given, the found instantiation is stored there.
+ *
+ * @return int - success 1 or failure 9, if there are no candidates.
+ */
+int processExact(RegionStore const& store, std::vector<storm::modelchecker::RegionResult> const& verdicts, ParameterSpace const& space, Instantiation const& initialInst, Metric const& metric, MonotonicityVector const& monotonicity, PlaOutcome* outcome = nullptr){
+    Instantiation newInst;
+    double distanceMin = std::numeric_limits<double>::infinity();
+    bool centerSat = false;
+    Box region;
+    uint64_t numberOfCandidates = 0;
+    store.forEachBlock([&](RegionStore::Block const& block){
+        BoxArray boxes(space.size());
+        std::vector<bool> fromCenter;
+        for(size_t i = 0; i < block.size; i++){
+            auto verdict = block.verdict(i);
+            if(std::find(verdicts.begin(), verdicts.end(), verdict) == verdicts.end()){
+                continue;
+            }
+            if(verdict == storm::modelchecker::RegionResult::AllSat){
+                Box box = block.box(i);
+                boxes.add(box.lower, box.upper);
+                fromCenter.push_back(false);
+            }else{
+                Instantiation center(space.size());
+                for(size_t d = 0; d < space.size(); d++){
+                    center[d] = (block.lower(i)[d] + block.upper(i)[d]) / 2;
+                }
+                boxes.add(center, center);
+                fromCenter.push_back(true);
+            }
+        }
+        if(boxes.empty()){
+            return;
+        }
+        numberOfCandidates += boxes.size();
+        //! Every block is searched once, so a linear search over its boxes is used
+        double distance;
+        size_t closest = boxes.closest(initialInst, metric, distance);
+        if(distance < distanceMin){
+            distanceMin = distance;
+            newInst = boxes.project(closest, initialInst);
+            centerSat = fromCenter[closest];
+            region = Box();
+            for(size_t d = 0; d < space.size(); d++){
+                region.lower.push_back(boxes.lower(closest, d));
+                region.upper.push_back(boxes.upper(closest, d));
+            }
+        }
+    });
+    if(newInst.empty()){
+        return 9;
+    }
+
+    std::cout << "Closest of " << numberOfCandidates << " regions." << std::endl;
+    //! The moved instantiation is only checked as a point, like the center of a CenterSat region
+    if(pushToBound(monotonicity, initialInst, newInst)){
+        distanceMin = metric.distance(initialInst, newInst);
+        centerSat = true;
+        std::cout << "Moved the instantiation to the boundary in the monotone parameters." << std::endl;
+    }
+    std::cout << distanceMin << " The " << metric.getName() << " - distance between the original and new instantiation:" <<std::endl;
+
+    reportInstantiation(space, newInst, distanceMin, centerSat, outcome, centerSat ? Box() : region);
+    return 1;
+}
+
+/*!
+ * A region in the queue of bestFirst, ordered by its minimal distance to the initial instantiation.
+ */
+struct BestFirstTask {
+    double bound;
+    uint_fast64_t depth;
+    storm::storage::ParameterRegion<storm::RationalFunction> region;
+
+    bool operator>(BestFirstTask const& other) const {
+        return bound > other.bound;
+    }
+};
+
+//! Without a depth limit, bestFirst halves every parameter at most this often, the parts are then close to the precision of double
+uint_fast64_t const BEST_FIRST_MAX_HALVINGS = 50;
+
+/*!
+ * Refines the region in the order of the minimal distance of its parts to the initial instantiation (branch and bound).
+ * A part, that cannot contain a point closer than the best satisfying point found so far, is never checked.
+ * The refinement stops as soon as the best point is at most bestFirstTolerance further away than any undecided part,
+ * or, like the refinement of storm, when the undecided parts that could still contain a closer point cover at most
+ * refThreshold of the region. The parts straddling the threshold of the property shrink with every halving, so the
+ * refinement also stops with tolerance 0, when the optimum lies on the threshold.
+ * Parts are halved along their longest side, so depthLimit allows depthLimit times as many halvings as there are parameters.
+ * Without a depth limit BEST_FIRST_MAX_HALVINGS per parameter are allowed.
+ * Every improvement of the best point is streamed as a candidate. With a time budget the refinement is stopped when the
+ * budget is used up and the best point so far is returned together with its certified gap.
+ *
+ * @param model - The model.
+ * @param formulae - The formulae to check, a region is AllSat if it satisfies all of them.
+ * @param region - The region to refine.
+ * @param space - The parameters.
+ * @param initialInst - The initial instantiation, used for computing the distance.
+ * @param metric - The metric of the distance.
+ * @param monotonicity - The monotonicity of every formula, may be empty.
+ * @param options - The options of the run.
+ * @param outcome - If given, the found instantiation, its distance and the optimality gap are stored there.
+ *
+ * @return int - success 1 or failure 9, if no satisfying point was found.
+ */
+int bestFirst(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model, std::vector<std::shared_ptr<const storm::logic::Formula>> const& formulae, storm::storage::ParameterRegion<storm::RationalFunction> const& region, ParameterSpace const& space, Instantiation const& initialInst, Metric const& metric, MonotonicityVector const& monotonicity, Options const& options, PlaOutcome* outcome = nullptr){
+    //!The minimal distance of a region to the initial instantiation
+    auto minDistance = [&initialInst, &metric](Box const& box){
+        return metric.distance(initialInst, getInstantiationFromBox(box, initialInst));
+    };
+
+    storm::Environment env;
+    std::unique_ptr<ConjunctionChecker> checkerOfPool = acquireChecker(model, formulae, monotonicity);
+    ConjunctionChecker& checker = *checkerOfPool;
+    auto hypothesis = storm::settings::getModule<storm::settings::modules::RegionSettings>().getHypothesis();
+    uint_fast64_t maxDepth = (options.depthLimit ? options.depthLimit.get() : BEST_FIRST_MAX_HALVINGS) * space.size();
+
+    //!The area of a part, parameters with a single value in the region do not count
+    Box regionBox = space.toBox(region);
+    auto area = [&regionBox](Box const& box){
+        double res = 1;
+        for(size_t i = 0; i < box.lower.size(); i++){
+            if(regionBox.upper[i] > regionBox.lower[i]){
+                res *= box.upper[i] - box.lower[i];
+            }
+        }
+        return res;
+    };
+    double thresholdArea = options.refThreshold * area(regionBox);
+
+    //!A min-heap of the parts, so it can be iterated when the best point improves
+    std::vector<BestFirstTask> queue;
+    std::greater<BestFirstTask> later;
+    queue.push_back(BestFirstTask{minDistance(regionBox), 0, region});
+    double incumbent = std::numeric_limits<double>::infinity();
+    double undecidedBound = std::numeric_limits<double>::infinity();
+    Instantiation best;
+    bool bestFromCenter = false;
+    Box bestBox;
+    uint_fast64_t checks = 0;
+    double tolerance = std::max(0.0, options.bestFirstTolerance);
+    bool interrupted = false;
+    //!The area of the parts in the queue, that could still contain a point closer than the best one
+    double openArea = area(regionBox);
+    auto improve = [&](double distance){
+        incumbent = distance;
+        openArea = 0;
+        for(auto const& task : queue){
+            if(task.bound < incumbent - tolerance){
+                openArea += area(space.toBox(task.region));
+            }
+        }
+    };
+
+    while(!queue.empty() && queue.front().bound < incumbent - tolerance && openArea > thresholdArea){
+        if(attemptStopped(options, attemptCancelled)){
+            interrupted = true;
+            break;
+        }
+        std::pop_heap(queue.begin(), queue.end(), later);
+        BestFirstTask current = queue.back();
+        queue.pop_back();
+        Box box = space.toBox(current.region);
+        openArea -= area(box);
+
+        auto res = checker.analyzeRegion(env, current.region, hypothesis);
+        checks++;
+        runReport.countChecked(1);
+        if(res == storm::modelchecker::RegionResult::AllViolated){
+            runReport.countRegions("AllViolated", 1);
+            continue;
+        }
+        if(res == storm::modelchecker::RegionResult::AllSat){
+            runReport.countRegions("AllSat", 1);
+            //!No undecided part is closer, so the closest point of this region is the best point so far
+            improve(current.bound);
+            best = getInstantiationFromBox(box, initialInst);
+            bestFromCenter = false;
+            bestBox = box;
+            streamCandidate(space, best, incumbent, false);
+            continue;
+        }
+        if(res == storm::modelchecker::RegionResult::CenterSat){
+            Instantiation centerPoint = space.toInstantiation(current.region.getCenterPoint());
+            double distance = metric.distance(initialInst, centerPoint);
+            if(distance < incumbent){
+                improve(distance);
+                best = centerPoint;
+                bestFromCenter = true;
+                bestBox = Box();
+                streamCandidate(space, best, incumbent, true);
+            }
+        }
+        if(current.depth >= maxDepth){
+            undecidedBound = std::min(undecidedBound, current.bound);
+            runReport.countRegions(res == storm::modelchecker::RegionResult::CenterSat ? "CenterSat" : "Unknown", 1);
+            continue;
+        }
+
+        //!Halve the longest side
+        size_t longest = 0;
+        for(size_t i = 1; i < space.size(); i++){
+            if(box.upper[i] - box.lower[i] > box.upper[longest] - box.lower[longest]){
+                longest = i;
+            }
+        }
+        runReport.countSplits(current.depth);
+        for(auto const& half : bisect(current.region, space.getVariable(longest))){
+            Box halfBox = space.toBox(half);
+            double bound = minDistance(halfBox);
+            if(bound < incumbent - tolerance){
+                openArea += area(halfBox);
+            }
+            queue.push_back(BestFirstTask{bound, current.depth + 1, half});
+            std::push_heap(queue.begin(), queue.end(), later);
+        }
+    }
+
+    std::cout << "Number of lifted model checks: " << checks << ", pruned regions: " << queue.size() << std::endl;
+    if(!monotonicity.empty()){
+        reportSavedChecks(checker.getSavedChecks());
+    }
+    releaseChecker(model, formulae, monotonicity, std::move(checkerOfPool));
+    if(interrupted){
+        std::cout << "The time budget is used up, the refinement was stopped." << std::endl;
+    }
+    if(outcome != nullptr){
+        outcome->interrupted = interrupted;
+    }
+    if(best.empty()){
+        return 9;
+    }
+    double lowerBound = std::min(undecidedBound, queue.empty() ? incumbent : queue.front().bound);
+    double gap = std::max(0.0, incumbent - lowerBound);
+
+    double distanceMin = metric.distance(initialInst, best);
+
+    std::cout << distanceMin << " The " << metric.getName() << " - distance between the original and new instantiation:" <<std::endl;
+    std::cout << gap << " The certified optimality gap of the " << metric.getName() << " - distance." <<std::endl;
+
+    reportInstantiation(space, best, distanceMin, bestFromCenter, outcome, bestBox);
+    if(outcome != nullptr){
+        outcome->gap = gap;
+    }
+    return 1;
+}
+
+/*!
+ * Opens the region cache for the model, the formulae and the parameters. The key contains everything the verdicts
+ * depend on: the checksum of the model file, the constants of a PRISM file, the formulae, the preprocessing of the model
+ * and the parameters.
+ *
+ * @param space - The parameters.
+ * @param formulae - The formulae.
+ * @param options - The options of the run, with cacheDirectory, regionCacheSize and modelChecksum.
+ *
+ * @return The cache.
+ */
+std::unique_ptr<RegionCache> openRegionCache(ParameterSpace const& space, std::vector<std::shared_ptr<const storm::logic::Formula>> const& formulae, Options const& options){
+    std::vector<std::string> parts = {std::to_string(options.modelChecksum), options.constants, options.preprocessing};
+    for(auto const& formula : formulae){
+        parts.push_back(formula->toString());
+    }
+    for(size_t i = 0; i < space.size(); i++){
+        parts.push_back(space.getName(i));
+    }
+    uint64_t sizeLimit = options.regionCacheSize > 0 ? static_cast<uint64_t>(options.regionCacheSize * 1024 * 1024) : 0;
+    return std::unique_ptr<RegionCache>(new RegionCache(options.cacheDirectory, RegionCache::key(parts), space.size(), sizeLimit));
+}
+
+/*!
+ * Calculates the constant to be used to change the parameter bounds in change_region.
+ *
+ * @param path_to_model - The path to the model file, given by the user.
+ * @param property_string - The property for which PLA would be executed.
+ * @param region_string - The initial values of the parameters, in most cases lb=ub, e.g. "0.5 <= p <= 0.5".
+ * @param epsilon - The initial value given by the user.
+ * @param options - The options of the run, e.g. how many times a region would be split by PLA before declared for Unknown.
+ * @param previous - The partition of the previous run, if given only the new outer shell of the region is refined.
+ * @param outcome - If given, the found instantiation and its distance are stored there.
+ *
+ * @return A vector containing only the SAT regions after the use of PLA.
+ */
+int refineAndSelect(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model, std::vector<std::shared_ptr<const storm::logic::Formula>> formulae, std::string region_string, double epsilon, Options const& options, bool flag = false, PreviousPartition* previous = nullptr, PlaOutcome* outcome = nullptr) {
+     //auto model = storm::parser::DirectEncodingParser<storm::RationalFunction>::parseModel(path_to_model)->template as<storm::models::sparse::Dtmc<storm::RationalFunction>>();
+
+     //!Extract parameters
+     auto modelParameters = storm::models::sparse::getProbabilityParameters(*model);
+     auto rewParameters = storm::models::sparse::getRewardParameters(*model);
+     modelParameters.insert(rewParameters.begin(), rewParameters.end());
+
+     std::cout << modelParameters << std::endl;
+
+     //! The initial instantiation is parsed once, everything else works on the parameter indices
+     ParameterSpace space(modelParameters);
+     Box initialBox = space.parseBox(region_string);
+     Instantiation initialInst = initialBox.upper;
+     Metric metric = buildMetric(space, options);
+     MonotonicityVector monotonicity;
+     if(options.monotonicity){
+         monotonicity = analyzeMonotonicity(model, formulae, space);
+     }
+
+     //! Uses the parameters and epsilon to calculate the constant to change the region and builds the new region
+     PhaseTimer regionBuildTimer(runReport, "regionBuild");
+     Box input;
+     if (flag) {
+        input = build_parSpace(space);
+     }else{
+         std::vector<double> bound = calc_bound(epsilon, metric, space.size());
+         input = build_region(space, initialBox, bound, options.clipRegion);
+     }
+     if(!monotonicity.empty()){
+         size_t restricted = restrictToImprovingSide(input, initialInst, combineMonotonicity(monotonicity, space.size()));
+         std::cout << "Restricted " << restricted << " monotone parameters to the improving side of the initial instantiation." << std::endl;
+     }
+     auto region = space.toRegion(input);
+     regionBuildTimer.stop();
+    //! Preparations for Model Checker
+    auto regionSettings = storm::settings::getModule<storm::settings::modules::RegionSettings>();
+    auto engine = options.exactEngine ? storm::modelchecker::RegionCheckEngine::ExactParameterLifting : regionSettings.getRegionCheckEngine();
+    if(formulae.size() > 1 && engine != storm::modelchecker::RegionCheckEngine::ParameterLifting){
+        throw std::invalid_argument("Several properties are only supported with the parameter lifting engine.");
+    }
+    boost::optional <uint_fast64_t> optionalDepthLimit = options.depthLimit;
+    auto refinementThreshold = storm::utility::convertNumber<storm::RationalFunction>(options.refThreshold);
+    //! Not using monotonicity. Comment this if you wan to use later version of storm.
+    uint_fast64_t monThresh = 0;
+    storm::api::MonotonicitySetting monotonicitySettings = storm::api::MonotonicitySetting();
+
+    std::ostringstream attempt;
+    if(flag){
+        attempt << "whole parameter space";
+    }else{
+        attempt << "epsilon=" << epsilon;
+    }
+    storm::utility::Stopwatch PLAwatch(true);
+    try {
+        //! Best-first refinement is anytime, so it is used for a time budget, unless several threads are used
+        //! and the lifted models in double precision
+        if((options.bestFirstTolerance >= 0 || (options.timeBudget >= 0 && options.numberOfThreads <= 1)) && !flag && !options.exactEngine){
+            int res = bestFirst(model, formulae, region, space, initialInst, metric, monotonicity, options, outcome);
+            PLAwatch.stop();
+            STORM_PRINT("Time for PLA: " << PLAwatch << ".\n\n");
+            runReport.addPhase("pla", attempt.str(), PLAwatch.getTimeInMilliseconds());
+            return res;
+        }
+
+        //! Only the shell around the previously checked region has to be refined, its verdicts are reused
+        std::vector<storm::storage::ParameterRegion<storm::RationalFunction>> toCheck;
+        uint64_t regionMemoryLimit = options.regionMemory > 0 ? static_cast<uint64_t>(options.regionMemory * 1024 * 1024) : 0;
+        RegionStore localStore(space.size(), options.keepViolated, regionMemoryLimit);
+        RegionStore* store = &localStore;
+        if(previous != nullptr && !flag){
+            if(previous->store && previous->region && isContainedIn(previous->region.get(), region)){
+                toCheck = build_shell(previous->region.get(), region);
+                std::cout << "Reusing " << previous->store->size() << " regions, refining " << toCheck.size() << " shell regions." << std::endl;
+            }else{
+                previous->store.reset(new RegionStore(space.size(), options.keepViolated, regionMemoryLimit));
+                toCheck.push_back(region);
+            }
+            store = previous->store.get();
+        }else{
+            toCheck.push_back(region);
+        }
+
+        //! Speculative attempts of the epsilon search use the own refinement, because it can be cancelled,
+        //! and so do several formulae, because the refinement of storm only checks a single formula,
+        //! and runs sharing the model, because the checkers have to be specified under the specificationMutex,
+        //! and the monotonicity, because the refinement of storm does not use the monotonicity analysed here
+        //! and the region cache, and a region memory limit or keepViolated, because the refinement of storm holds all
+        //! regions until it is done, while the own refinement adds them to the store as soon as they are decided
+        std::unique_ptr<RegionCache> cache;
+        if(!options.cacheDirectory.empty() && engine == storm::modelchecker::RegionCheckEngine::ParameterLifting){
+            cache = openRegionCache(space, formulae, options);
+        }
+        if((options.numberOfThreads > 1 || options.concurrent || attemptCancelled != nullptr || formulae.size() > 1 || !monotonicity.empty() || cache || options.regionMemory > 0 || options.keepViolated) && engine == storm::modelchecker::RegionCheckEngine::ParameterLifting){
+            parallelRefinement(model, formulae, space, toCheck, regionSettings.getHypothesis(), monotonicity, options, *store, cache.get());
+            if(cache){
+                std::cout << "Region cache: " << cache->save() << " regions stored." << std::endl;
+            }
+        }else{
+            //! The checker of the parameter lifting engine is specified once and reused by the next calls
+            std::unique_ptr<LiftingChecker> liftingChecker;
+            std::string key = checkerKey(formulae, MonotonicityVector());
+            if(engine == storm::modelchecker::RegionCheckEngine::ParameterLifting){
+                liftingChecker = liftingCheckers.acquire(model, key, [&](LiftingChecker& checker){
+                    std::lock_guard<std::mutex> lock(specificationMutex);
+                    checker.specify(storm::Environment(), model, storm::api::createTask<storm::RationalFunction>(formulae[0], true), false, false);
+                });
+            }
+            for(auto const& reg : toCheck){
+                std::unique_ptr<storm::modelchecker::RegionRefinementCheckResult<storm::RationalFunction>> result;
+                if(liftingChecker){
+                    storm::Environment env;
+                    result = liftingChecker->performRegionRefinement(env, reg, refinementThreshold, optionalDepthLimit, regionSettings.getHypothesis(), monThresh);
+                }else{
+                    result = storm::api::checkAndRefineRegionWithSparseEngine<storm::RationalFunction>(
+                            model, storm::api::createTask<storm::RationalFunction>(formulae[0], true), reg, engine,
+                            refinementThreshold,
+                            optionalDepthLimit, regionSettings.getHypothesis(), false);
+                }
+                //! The refinement of storm returns all regions at once, they are moved to the store right away
+                for(auto const& res : result->getRegionResults()){
+                    store->add(space.toBox(res.first), res.second);
+                }
+                countRefinement(space, reg, result->getRegionResults());
+            }
+            if(liftingChecker){
+                liftingCheckers.release(model, key, std::move(liftingChecker));
+            }
+        }
+
+        if(previous != nullptr && !flag){
+            previous->region = region;
+        }
+
+    PLAwatch.stop();
+    STORM_PRINT("Time for PLA: " << PLAwatch << ".\n\n");
+    runReport.addPhase("pla", attempt.str(), PLAwatch.getTimeInMilliseconds());
+    printRegionCounts(*store);
+    PhaseTimer selectionTimer(runReport, "selection");
+
+    uint64_t numberOfAllSat = store->count(storm::modelchecker::RegionResult::AllSat);
+    if(numberOfAllSat == 0) {
+		if(store->count(storm::modelchecker::RegionResult::CenterSat) == 0){
+            if(flag){
+                return 23;
+            }
+			return 9;
+		}
+        if(options.exactSelection){
+            return processExact(*store, {storm::modelchecker::RegionResult::CenterSat}, space, initialInst, metric, monotonicity, outcome);
+        }
+        return processCenterSat(*store, space, initialInst, metric, options, outcome);
+    }
+
+    if(options.exactSelection){
+        std::vector<storm::modelchecker::RegionResult> verdicts = {storm::modelchecker::RegionResult::AllSat};
+        if(options.includeCenterSat){
+            verdicts.push_back(storm::modelchecker::RegionResult::CenterSat);
+        }
+        return processExact(*store, verdicts, space, initialInst, metric, monotonicity, outcome);
+    }
+
+    //! A copy, so that the option is the same for the next call
+    size_t remaining = options.numberOfRandom;
+    if(numberOfAllSat < remaining){
+        std::cout << "There are only this much AllSatregions:"<< numberOfAllSat <<std::endl;
+        remaining = numberOfAllSat;
+    }
+
+    //! The random regions are drawn first and then collected in a single pass over the store
+    std::vector<uint64_t> drawn;
+    drawn.push_back(getRandomRegion(numberOfAllSat));
+    while(drawn.size() < remaining){
+        drawn.push_back(getRandomRegion(numberOfAllSat));
+    }
+    std::map<uint64_t, Box> drawnBoxes;
+    for(uint64_t reg : drawn){
+        drawnBoxes[reg];
+    }
+    uint64_t rank = 0;
+    store->forEachBlock([&](RegionStore::Block const& block){
+        for(size_t i = 0; i < block.size; i++){
+            if(block.verdict(i) != storm::modelchecker::RegionResult::AllSat){
+                continue;
+            }
+            auto it = drawnBoxes.find(rank++);
+            if(it != drawnBoxes.end()){
+                it->second = block.box(i);
+            }
+        }
+    });
+
+    Box newBox = drawnBoxes[drawn[0]];
+    Instantiation newInst = getInstantiationFromBox(newBox, initialInst);
+
+    double distanceMin = metric.distance(initialInst, newInst);
+
+    for(size_t k = 1; k < drawn.size(); k++){
+        Instantiation candidate = getInstantiationFromBox(drawnBoxes[drawn[k]], initialInst);
+        double candDistance = metric.distance(initialInst, candidate);
+        if(candDistance < distanceMin){
+            newInst = candidate;
+            newBox = drawnBoxes[drawn[k]];
+            distanceMin = candDistance;
+        }
+    }
+
+
+    std::cout << distanceMin << " The " << metric.getName() << " - distance between the original and new instantiation:" <<std::endl; 
+
+    reportInstantiation(space, newInst, distanceMin, false, outcome, newBox);
+
+    }catch(storm::exceptions::InvalidArgumentException e){
+        throw std::invalid_argument("Epsilon is to big and the bounded region is making the transition matrix non-stochastic. Please choose smaller epsilon or change initial values.");
+    }
+
+    return 1;
+}
+
+/*!
+ * Checks the instantiation found by PLA again in exact arithmetic. The regions of PLA are checked on lifted models in
+ * double precision, so a verdict close to the threshold may be wrong. The AllSat region the instantiation was selected
+ * from and the instantiation itself, as a region of size zero, are checked by parameter lifting with rational numbers.
+ *
+ * @param model - The model.
+ * @param formulae - The formulae, the instantiation has to satisfy all of them.
+ * @param space - The parameters.
+ * @param outcome - The outcome of PLA.
+ *
+ * @return true if the region (if any) and the instantiation are AllSat for all formulae.
+ */
+bool certifyOutcome(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model, std::vector<std::shared_ptr<const storm::logic::Formula>> const& formulae, ParameterSpace const& space, PlaOutcome const& outcome){
+    typedef storm::modelchecker::SparseDtmcParameterLiftingModelChecker<storm::models::sparse::Dtmc<storm::RationalFunction>, storm::RationalNumber> ExactChecker;
+    Instantiation point;
+    for(auto const& value : outcome.instantiation){
+        point.push_back(value.second);
+    }
+    //!The bounds are converted exactly, so the reported instantiation and region are checked and not rounded ones
+    std::vector<storm::storage::ParameterRegion<storm::RationalFunction>> regions;
+    if(!outcome.region.lower.empty()){
+        regions.push_back(space.toExactRegion(outcome.region));
+    }
+    regions.push_back(space.toExactRegion(Box{point, point}));
+
+    try{
+        storm::Environment env;
+        for(auto const& formula : formulae){
+            ExactChecker checker;
+            {
+                std::lock_guard<std::mutex> lock(specificationMutex);
+                checker.specify(env, model, storm::api::createTask<storm::RationalFunction>(formula, true), false, false);
+            }
+            for(auto const& region : regions){
+                if(checker.analyzeRegion(env, region, storm::modelchecker::RegionResultHypothesis::Unknown, storm::modelchecker::RegionResult::Unknown, false) != storm::modelchecker::RegionResult::AllSat){
+                    return false;
+                }
+            }
+        }
+    }catch(storm::exceptions::InvalidArgumentException const&){
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * Runs PLA (see refineAndSelect). With certify, the regions are refined on lifted models in double precision and only
+ * the found instantiation is certified exactly (see certifyOutcome). If the certification fails, PLA is repeated with the
+ * exact parameter lifting engine of storm.
+ *
+ * @param model - The model.
+ * @param formulae - The formulae.
+ * @param region_string - The initial values of the parameters, in most cases lb=ub, e.g. "0.5 <= p <= 0.5".
+ * @param epsilon - The initial value given by the user.
+ * @param options - The options of the run.
+ * @param flag - If the whole parameter space is checked.
+ * @param previous - The partition of the previous run, if given only the new outer shell of the region is refined.
+ * @param outcome - If given, the found instantiation and its distance are stored there.
+ *
+ * @return 1 if a solution was found, 9 if none was found, 23 if no solution exists.
+ */
+int pla(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model, std::vector<std::shared_ptr<const storm::logic::Formula>> formulae, std::string region_string, double epsilon, Options const& options, bool flag = false, PreviousPartition* previous = nullptr, PlaOutcome* outcome = nullptr) {
+    if(!options.certify || options.exactEngine){
+        return refineAndSelect(model, formulae, region_string, epsilon, options, flag, previous, outcome);
+    }
+    PlaOutcome found;
+    PlaOutcome* target = outcome != nullptr ? outcome : &found;
+    int res = refineAndSelect(model, formulae, region_string, epsilon, options, flag, previous, target);
+    if(res != 1){
+        return res;
+    }
+
+    auto modelParameters = storm::models::sparse::getProbabilityParameters(*model);
+    auto rewParameters = storm::models::sparse::getRewardParameters(*model);
+    modelParameters.insert(rewParameters.begin(), rewParameters.end());
+    storm::utility::Stopwatch certificationWatch(true);
+    bool certified = certifyOutcome(model, formulae, ParameterSpace(modelParameters), *target);
+    certificationWatch.stop();
+    STORM_PRINT("Time for the exact certification: " << certificationWatch << ".\n\n");
+    runReport.addPhase("certification", flag ? "whole parameter space" : "epsilon=" + std::to_string(epsilon), certificationWatch.getTimeInMilliseconds());
+    if(certified){
+        std::cout << "The instantiation is certified in exact arithmetic." << std::endl;
+        return 1;
+    }
+
+    std::cout << "The exact certification failed, PLA is repeated with the exact engine." << std::endl;
+    if(!options.batchRow){
+        runReport.setResult("certificationFailed", "true");
+    }
+    *target = PlaOutcome();
+    if(formulae.size() > 1){
+        std::cout << "The exact engine only supports a single property." << std::endl;
+        return 9;
+    }
+    Options exactOptions = options;
+    exactOptions.exactEngine = true;
+    return refineAndSelect(model, formulae, region_string, epsilon, exactOptions, flag, nullptr, target);
+}
+
+/*!
+ * Removes the states, that have a single successor and are not relevant for the formulae, by redirecting their
+ * incoming transitions to the first state of their chain that is kept. As such a state is left with probability one,
+ * the probability to reach the target states does not change. Only done for unbounded reachability formulae.
+ *
+ * @param model - The model.
+ * @param formulae - The formulae.
+ *
+ * @return The reduced model or the model itself, if nothing can be eliminated.
+ */
+std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> eliminateChains(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model, std::vector<std::shared_ptr<const storm::logic::Formula>> const& formulae){
+    if(model->hasRewardModel()){
+        return model;
+    }
+    for(auto const& formula : formulae){
+        if(!formula->isInFragment(storm::logic::reachability()) || !formula->getAtomicExpressionFormulas().empty()){
+            return model;
+        }
+    }
+    auto const& matrix = model->getTransitionMatrix();
+    uint_fast64_t numberOfStates = model->getNumberOfStates();
+
+    //!The initial states and the states with a label of one of the formulae are kept
+    storm::storage::BitVector relevant = model->getInitialStates();
+    for(auto const& formula : formulae){
+        for(auto const& label : formula->getAtomicLabelFormulas()){
+            relevant |= model->getStateLabeling().getStates(label->getLabel());
+        }
+    }
+
+    //!The successor of every state that can be eliminated, numberOfStates for the kept states
+    std::vector<uint_fast64_t> successor(numberOfStates, numberOfStates);
+    for(uint_fast64_t state = 0; state < numberOfStates; state++){
+        auto row = matrix.getRow(state);
+        if(!relevant.get(state) && row.getNumberOfEntries() == 1 && row.begin()->getColumn() != state){
+            successor[state] = row.begin()->getColumn();
+        }
+    }
+
+    //!Follow the chains to the first kept state, a chain that forms a cycle keeps the state where the cycle closes
+    std::vector<uint_fast64_t> target(numberOfStates, numberOfStates);
+    for(uint_fast64_t state = 0; state < numberOfStates; state++){
+        if(successor[state] == numberOfStates){
+            target[state] = state;
+        }
+    }
+    std::vector<bool> onPath(numberOfStates, false);
+    for(uint_fast64_t state = 0; state < numberOfStates; state++){
+        std::vector<uint_fast64_t> path;
+        uint_fast64_t current = state;
+        while(target[current] == numberOfStates && !onPath[current]){
+            onPath[current] = true;
+            path.push_back(current);
+            current = successor[current];
+        }
+        if(target[current] == numberOfStates){
+            successor[current] = numberOfStates;
+            target[current] = current;
+        }
+        for(auto const& onChain : path){
+            target[onChain] = target[current];
+            onPath[onChain] = false;
+        }
+    }
+
+    storm::storage::BitVector kept(numberOfStates);
+    std::vector<uint_fast64_t> newIndex(numberOfStates, 0);
+    uint_fast64_t numberOfKept = 0;
+    for(uint_fast64_t state = 0; state < numberOfStates; state++){
+        if(successor[state] == numberOfStates){
+            kept.set(state);
+            newIndex[state] = numberOfKept++;
+        }
+    }
+    if(numberOfKept == numberOfStates){
+        return model;
+    }
+
+    storm::storage::SparseMatrixBuilder<storm::RationalFunction> builder(numberOfKept, numberOfKept, 0, true, false);
+    for(auto const& state : kept){
+        std::map<uint_fast64_t, storm::RationalFunction> row;
+        for(auto const& entry : matrix.getRow(state)){
+            uint_fast64_t column = newIndex[target[entry.getColumn()]];
+            auto it = row.find(column);
+            if(it == row.end()){
+                row.emplace(column, entry.getValue());
+            }else{
+                it->second = it->second + entry.getValue();
+            }
+        }
+        for(auto const& entry : row){
+            builder.addNextValue(newIndex[state], entry.first, entry.second);
+        }
+    }
+    return std::make_shared<storm::models::sparse::Dtmc<storm::RationalFunction>>(builder.build(), model->getStateLabeling().getSubLabeling(kept));
+}
+
+/*!
+ * Reduces the model before the first PLA call with the steps given in preprocessing, in the given order: "simplify" for
+ * the property driven simplification, "bisimulation" for the strong bisimulation minimization and "elimination" for
+ * eliminateChains. Prints the number of states and transitions after every step.
+ *
+ * @param model - The model, replaced by the reduced model.
+ * @param formulae - The formulae, replaced by the simplified formula. The simplification is only done for a single formula.
+ * @param options - The options of the run.
+ */
+void preprocessModel(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>>& model, std::vector<std::shared_ptr<const storm::logic::Formula>>& formulae, Options const& options){
+    if(options.preprocessingSteps.empty()){
+        return;
+    }
+    storm::utility::Stopwatch preprocessingWatch(true);
+    std::cout << "Before preprocessing: " << model->getNumberOfStates() << " states, " << model->getNumberOfTransitions() << " transitions." << std::endl;
+
+    for(auto const& step : options.preprocessingSteps){
+        if(step == "simplify" && formulae.size() > 1){
+            std::cout << "The simplification is skipped, it is only done for a single property." << std::endl;
+        }else if(step == "simplify"){
+            storm::transformer::SparseParametricDtmcSimplifier<storm::models::sparse::Dtmc<storm::RationalFunction>> simplifier(*model);
+            if(simplifier.simplify(*formulae[0])){
+                model = simplifier.getSimplifiedModel();
+                formulae[0] = simplifier.getSimplifiedFormula();
+            }
+            std::cout << "After simplification: " << model->getNumberOfStates() << " states, " << model->getNumberOfTransitions() << " transitions." << std::endl;
+        }else if(step == "bisimulation"){
+            model = storm::api::performBisimulationMinimization<storm::RationalFunction>(model, formulae, storm::storage::BisimulationType::Strong)->template as<storm::models::sparse::Dtmc<storm::RationalFunction>>();
+            std::cout << "After bisimulation: " << model->getNumberOfStates() << " states, " << model->getNumberOfTransitions() << " transitions." << std::endl;
+        }else if(step == "elimination"){
+            model = eliminateChains(model, formulae);
+            std::cout << "After elimination: " << model->getNumberOfStates() << " states, " << model->getNumberOfTransitions() << " transitions." << std::endl;
+        }
+    }
+
+    preprocessingWatch.stop();
+    STORM_PRINT("Time for preprocessing: " << preprocessingWatch << ".\n\n");
+    runReport.addPhase("preprocessing", options.preprocessing, preprocessingWatch.getTimeInMilliseconds());
+}
+
+/*!
+ * Instead of PLA over an epsilon region, the solution function of the first formula is computed once and the closest
+ * point on the boundary of the threshold is searched from the initial instantiation by a projected Newton iteration:
+ * the closest point to the initial instantiation on the linearization of the constraint is taken and clamped to [0,1],
+ * until the point does not move anymore. The closest point is taken in the weighted L2 metric with the weights of the
+ * chosen metric, for L1 and Linf the found point is therefore not necessarily the closest one. The found point is checked exactly on the solution function and a small box
+ * around it is certified with a parameter lifting check. The box is sized from the margin h(x) of the point and the gradient
+ * of h, so that the linearization of the constraint holds on it. If the box is not AllSat, the point is moved further into the
+ * feasible side and the check is repeated.
+ *
+ * @param model - The model.
+ * @param formulae - The formulae, must be a single formula.
+ * @param region_string - The initial instantiation in form of a region.
+ * @param options - The options of the run.
+ * @param outcome - If given, the found instantiation and its distance are stored there.
+ *
+ * @return 1 if a solution was found, 9 if none was found.
+ */
+int solutionFunctionSearch(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model, std::vector<std::shared_ptr<const storm::logic::Formula>> formulae, std::string region_string, Options const& options, PlaOutcome* outcome = nullptr){
+    typedef storm::utility::parametric::Valuation<storm::RationalFunction> Valuation;
+    STORM_LOG_THROW(formulae.size() == 1, storm::exceptions::InvalidArgumentException, "The solution function mode supports only a single property.");
+    auto const& formula = *formulae[0];
+    STORM_LOG_THROW(formula.isProbabilityOperatorFormula() && formula.asOperatorFormula().hasBound(), storm::exceptions::InvalidArgumentException, "The solution function mode needs a probability formula with a bound, e.g. P>=0.3 [F \"target\"]");
+
+    ParameterSpace space(storm::models::sparse::getProbabilityParameters(*model));
+    std::vector<storm::RationalFunctionVariable> const& variables = space.getVariables();
+    Instantiation initial = space.parseBox(region_string).upper;
+    Metric metric = buildMetric(space, options);
+
+    storm::utility::Stopwatch functionWatch(true);
+    storm::RationalFunction function;
+    std::vector<storm::RationalFunction> gradient;
+    {
+        //! The new polynomials are added to the polynomial cache of carl, see specificationMutex
+        std::lock_guard<std::mutex> lock(specificationMutex);
+        function = computeSolutionFunction(model, formula);
+        for(auto const& var : variables){
+            gradient.push_back(function.derivative(var));
+        }
+    }
+    functionWatch.stop();
+    STORM_PRINT("Time for the solution function: " << functionWatch << ".\n\n");
+    runReport.addPhase("solutionFunction", "", functionWatch.getTimeInMilliseconds());
+
+    //!The constraint is h(x) >= 0, with h(x) = f(x) - threshold for lower bounds and threshold - f(x) for upper bounds
+    auto comparison = formula.asOperatorFormula().getComparisonType();
+    double sign = (comparison == storm::logic::ComparisonType::Greater || comparison == storm::logic::ComparisonType::GreaterEqual) ? 1 : -1;
+    auto threshold = formula.asOperatorFormula().getThresholdAs<storm::RationalFunctionCoefficient>();
+    auto toValuation = [&variables](std::vector<double> const& point){
+        Valuation valuation;
+        for(size_t i = 0; i < variables.size(); i++){
+            valuation[variables[i]] = storm::utility::convertNumber<storm::RationalFunctionCoefficient>(point[i]);
+        }
+        return valuation;
+    };
+    //!Checks the constraint exactly
+    auto satisfies = [&](std::vector<double> const& point){
+        auto value = function.evaluate(toValuation(point));
+        switch(comparison){
+            case storm::logic::ComparisonType::Greater: return threshold < value;
+            case storm::logic::ComparisonType::GreaterEqual: return threshold <= value;
+            case storm::logic::ComparisonType::Less: return value < threshold;
+            default: return value <= threshold;
+        }
+    };
+    auto h = [&](std::vector<double> const& point){
+        return sign * (storm::utility::convertNumber<double>(function.evaluate(toValuation(point))) - storm::utility::convertNumber<double>(threshold));
+    };
+
+    //!The gradient of h
+    auto gradientOfH = [&](std::vector<double> const& point){
+        Valuation valuation = toValuation(point);
+        std::vector<double> g;
+        for(size_t i = 0; i < variables.size(); i++){
+            g.push_back(sign * storm::utility::convertNumber<double>(gradient[i].evaluate(valuation)));
+        }
+        return g;
+    };
+    //!The projected Newton iteration towards the closest point with h(x) = margin
+    auto newton = [&](double margin){
+        std::vector<double> x = initial;
+        for(int iteration = 0; iteration < 100; iteration++){
+            std::vector<double> g = gradientOfH(x);
+            double gg = 0;
+            double gDiff = 0;
+            for(size_t i = 0; i < variables.size(); i++){
+                gg += g[i] * g[i] / (metric.weight(i) * metric.weight(i));
+                gDiff += g[i] * (initial[i] - x[i]);
+            }
+            if(gg < 1e-300){
+                break;
+            }
+            double lambda = (margin - h(x) - gDiff) / gg;
+            double step = 0;
+            std::vector<double> next;
+            for(size_t i = 0; i < variables.size(); i++){
+                next.push_back(std::min(1.0, std::max(0.0, initial[i] + lambda * g[i] / (metric.weight(i) * metric.weight(i)))));
+                step += std::abs(next[i] - x[i]);
+            }
+            x = next;
+            if(step < 1e-12){
+                break;
+            }
+        }
+        return x;
+    };
+
+    storm::utility::Stopwatch searchWatch(true);
+    Instantiation best;
+    bool fromInitial = satisfies(initial);
+    if(fromInitial){
+        best = initial;
+    }
+    //!If the point misses the threshold because of rounding, the iteration is repeated aiming further into the feasible side
+    double margin = 1e-9;
+    for(; best.empty() && margin < 1e-2; margin *= 100){
+        std::vector<double> x = newton(margin);
+        if(satisfies(x)){
+            best = x;
+            break;
+        }
+    }
+    searchWatch.stop();
+    STORM_PRINT("Time for the search: " << searchWatch << ".\n\n");
+    runReport.addPhase("search", "", searchWatch.getTimeInMilliseconds());
+
+    if(best.empty()){
+        std::cout << "The search on the solution function did not find a feasible instantiation." << std::endl;
+        return 9;
+    }
+
+    //!Certify a small box around the point, the point itself is already checked exactly
+    typedef storm::modelchecker::SparseDtmcParameterLiftingModelChecker<storm::models::sparse::Dtmc<storm::RationalFunction>, double> Checker;
+    storm::utility::Stopwatch PLAwatch(true);
+    bool certified = false;
+    Box box;
+    try{
+        storm::Environment env;
+        Checker checker;
+        {
+            std::lock_guard<std::mutex> lock(specificationMutex);
+            checker.specify(env, model, storm::api::createTask<storm::RationalFunction>(formulae[0], true), false, false);
+        }
+        Instantiation point = best;
+        //!On a box of half width h(x) / |grad h(x)|_1 the linearization of h stays positive, half of it leaves room for the curvature
+        double shrink = 0.5;
+        for(int attempt = 0; attempt < 5 && !certified; attempt++){
+            if(attempt > 0){
+                if(fromInitial){
+                    //!The initial instantiation is the optimum, so only the box is made smaller
+                    shrink /= 10;
+                }else{
+                    margin *= 10;
+                    Instantiation further = newton(margin);
+                    if(!satisfies(further)){
+                        break;
+                    }
+                    point = further;
+                }
+            }
+            std::vector<double> g = gradientOfH(point);
+            double norm = 0;
+            for(auto const& gi : g){
+                norm += std::abs(gi);
+            }
+            double halfWidth = norm > 0 ? shrink * std::max(0.0, h(point)) / norm : 1e-6;
+            box = Box();
+            for(size_t i = 0; i < space.size(); i++){
+                box.lower.push_back(std::max(0.0, point[i] - halfWidth));
+                box.upper.push_back(std::min(1.0, point[i] + halfWidth));
+            }
+            certified = checker.analyzeRegion(env, space.toExactRegion(box), storm::modelchecker::RegionResultHypothesis::Unknown, storm::modelchecker::RegionResult::Unknown, false) == storm::modelchecker::RegionResult::AllSat;
+            if(certified){
+                best = point;
+            }
+        }
+    }catch(storm::exceptions::InvalidArgumentException const&){
+        certified = false;
+    }
+    PLAwatch.stop();
+    STORM_PRINT("Time for PLA: " << PLAwatch << ".\n\n");
+    runReport.addPhase("pla", "certification", PLAwatch.getTimeInMilliseconds());
+    std::cout << (certified ? "The box around the instantiation is AllSat." : "Only the instantiation itself is checked, the box around it is not AllSat.") << std::endl;
+
+    double distanceMin = metric.distance(initial, best);
+    std::cout << distanceMin << " The " << metric.getName() << " - distance between the original and new instantiation:" <<std::endl;
+
+    reportInstantiation(space, best, distanceMin, !certified, outcome, certified ? box : Box());
+    return 1;
+}
+
+/*!
+ * A PLA attempt of the epsilon search.
+ */
+struct EpsilonAttempt {
+    double epsilon;
+    //! If the whole parameter space is checked to show that no solution exists (see faster)
+    bool wholeSpace;
+    int status = 9;
+    PlaOutcome outcome;
+    std::exception_ptr error;
+    std::atomic<bool> cancelled;
+    //! If the attempt is finished, then it is not cancelled anymore
+    bool done = false;
+
+    EpsilonAttempt(double epsilon, bool wholeSpace) : epsilon(epsilon), wholeSpace(wholeSpace), cancelled(false) {
+    }
+};
+
+/*!
+ * Searches the smallest epsilon, for which PLA finds a solution, up to epsilonTolerance. Epsilon is doubled until a
+ * solution is found (bracketing), then the interval between the largest epsilon without and the smallest epsilon with
+ * a solution is bisected, until the interval is at most epsilonTolerance or a round does not narrow it anymore. Doubling
+ * stops at the epsilon, whose region covers the whole parameter space. In every round speculativeAttempts epsilons are tried at once, each on its own thread: while
+ * bracketing epsilon, 2 epsilon, 4 epsilon, ..., while bisecting evenly spaced points of the interval. As soon as an
+ * attempt finds a solution, the attempts with a bigger epsilon are cancelled, as soon as one finds none, the attempts
+ * with a smaller one. If faster is set, the check of the whole parameter space runs as an additional attempt of the
+ * first round and ends the search, if it shows that no solution exists.
+ *
+ * @param model - The parametric model.
+ * @param formulae - The formulae.
+ * @param region_string - The initial instantiation in form of a region.
+ * @param epsilon - The initial value given by the user.
+ * @param options - The options of the run.
+ * @param outcome - If given, the solution for the smallest epsilon is stored there.
+ *
+ * @return 1 if a solution was found, 9 if none was found, 23 if no solution exists.
+ */
+int epsilonSearch(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model, std::vector<std::shared_ptr<const storm::logic::Formula>> formulae, std::string region_string, double epsilon, Options const& options, PlaOutcome* outcome = nullptr){
+    auto modelParameters = storm::models::sparse::getProbabilityParameters(*model);
+    auto rewParameters = storm::models::sparse::getRewardParameters(*model);
+    modelParameters.insert(rewParameters.begin(), rewParameters.end());
+    ParameterSpace space(modelParameters);
+    Metric metric = buildMetric(space, options);
+    //! Epsilon, from which on the region contains the whole parameter space
+    double wholeSpaceEpsilon = 0;
+    for(size_t i = 0; i < space.size(); i++){
+        wholeSpaceEpsilon = std::max(wholeSpaceEpsilon, 1.0 / metric.radius(1.0, i, space.size()));
+    }
+
+    double lower = 0;
+    double upper = -1;
+    //! The largest epsilon tried while bracketing
+    double bracketed = 0;
+    //! Doubling has to start from a positive epsilon
+    epsilon = std::max(epsilon, options.epsilonTolerance > 0 ? options.epsilonTolerance : 1e-3);
+    Options attemptOptions = options;
+    attemptOptions.clipRegion = true;
+    PlaOutcome best;
+    bool firstRound = true;
+    size_t const width = std::max<size_t>(options.speculativeAttempts, 1);
+
+    while(!budgetExhausted(options)){
+        std::vector<std::unique_ptr<EpsilonAttempt>> attempts;
+        if(upper < 0){
+            for(size_t i = 0; i < width && bracketed < wholeSpaceEpsilon; i++){
+                bracketed = std::min(epsilon, wholeSpaceEpsilon);
+                attempts.emplace_back(new EpsilonAttempt(bracketed, false));
+                epsilon *= 2;
+            }
+            if(attempts.empty()){
+                std::cout << "Epsilon search: no solution found up to epsilon " << lower << "." << std::endl;
+                break;
+            }
+        }else{
+            if(upper - lower <= options.epsilonTolerance){
+                break;
+            }
+            for(size_t i = 1; i <= width; i++){
+                attempts.emplace_back(new EpsilonAttempt(lower + (upper - lower) * i / (width + 1), false));
+            }
+        }
+        if(firstRound && options.faster){
+            attempts.emplace_back(new EpsilonAttempt(0, true));
+        }
+        firstRound = false;
+
+        std::mutex resultMutex;
+        bool const speculative = attempts.size() > 1;
+        auto run = [&](EpsilonAttempt* attempt){
+            //! A single attempt is not cancelled, so it can use the refinement of storm
+            attemptCancelled = speculative ? &attempt->cancelled : nullptr;
+            try{
+                attempt->status = pla(model, formulae, region_string, attempt->epsilon, attemptOptions, attempt->wholeSpace, nullptr, &attempt->outcome);
+            }catch(...){
+                attempt->error = std::current_exception();
+            }
+            attemptCancelled = nullptr;
+
+            std::lock_guard<std::mutex> lock(resultMutex);
+            attempt->done = true;
+            if(attempt->cancelled){
+                return;
+            }
+            bool found = attempt->status == 1 && !attempt->wholeSpace;
+            bool notFound = attempt->status != 1 && !attempt->wholeSpace && !attempt->error;
+            for(auto& other : attempts){
+                if(other->done || (other->wholeSpace && attempt->status != 23)){
+                    continue;
+                }
+                if(attempt->status == 23 || (found && other->epsilon > attempt->epsilon) || (notFound && other->epsilon < attempt->epsilon)){
+                    other->cancelled = true;
+                }
+            }
+        };
+        if(!speculative){
+            run(attempts.front().get());
+        }else{
+            std::vector<std::thread> threads;
+            for(auto& attempt : attempts){
+                threads.emplace_back(run, attempt.get());
+            }
+            for(auto& thread : threads){
+                thread.join();
+            }
+        }
+
+        std::exception_ptr error;
+        bool foundInRound = false;
+        double previousLower = lower;
+        double previousUpper = upper;
+        for(auto& attempt : attempts){
+            if(attempt->wholeSpace){
+                if(attempt->status == 23){
+                    std::cout << "Epsilon search: the whole parameter space has no solution." << std::endl;
+                    if(outcome != nullptr){
+                        outcome->status = 23;
+                    }
+                    return 23;
+                }
+                continue;
+            }
+            if(attempt->cancelled){
+                continue;
+            }
+            if(attempt->error){
+                error = attempt->error;
+            }else if(attempt->status == 1 && (upper < 0 || attempt->epsilon < upper)){
+                upper = attempt->epsilon;
+                best = attempt->outcome;
+                foundInRound = true;
+            }else if(attempt->status != 1 && attempt->epsilon > lower && (upper < 0 || attempt->epsilon < upper)){
+                lower = attempt->epsilon;
+            }
+        }
+        std::cout << "Epsilon search: no solution up to " << lower << ", solution for " << (upper < 0 ? std::string("none") : std::to_string(upper)) << "." << std::endl;
+        if(error && !foundInRound && upper < 0){
+            std::rethrow_exception(error);
+        }
+        //! A bisection round, whose attempts all failed or were cancelled, or that reached the precision of double
+        if(previousUpper >= 0 && lower == previousLower && upper == previousUpper){
+            std::cout << "Epsilon search: the interval cannot be narrowed anymore." << std::endl;
+            break;
+        }
+    }
+
+    if(upper < 0){
+        return 9;
+    }
+    std::cout << "Smallest epsilon with a solution: " << upper << std::endl;
+    std::cout << best.distance << " The " << metric.getName() << " - distance between the original and new instantiation:" <<std::endl;
+    for(auto const& value : best.instantiation){
+        std::cout << value.first << "= " << value.second << std::endl;
+    }
+    if(outcome != nullptr){
+        *outcome = best;
+    }
+    return 1;
+}
+
+/*!
+ * Generates quasi-random points in a box, the Halton sequence with the first primes as bases. Unlike random points,
+ * they cover the box evenly already for few points.
+ *
+ * @param box - The box.
+ * @param numberOfPoints - The number of points.
+ *
+ * @return The points.
+ */
+std::vector<Instantiation> haltonPoints(Box const& box, size_t numberOfPoints){
+    std::vector<uint64_t> bases;
+    for(uint64_t candidate = 2; bases.size() < box.lower.size(); candidate++){
+        bool prime = true;
+        for(uint64_t base : bases){
+            prime = prime && candidate % base != 0;
+        }
+        if(prime){
+            bases.push_back(candidate);
+        }
+    }
+    std::vector<Instantiation> res;
+    //! The first point of the sequence is the lower corner, so it is skipped
+    for(uint64_t index = 1; index <= numberOfPoints; index++){
+        Instantiation point;
+        for(size_t d = 0; d < bases.size(); d++){
+            double value = 0;
+            double fraction = 1;
+            for(uint64_t rest = index; rest > 0; rest /= bases[d]){
+                fraction /= bases[d];
+                value += fraction * (rest % bases[d]);
+            }
+            point.push_back(box.lower[d] + value * (box.upper[d] - box.lower[d]));
+        }
+        res.push_back(point);
+    }
+    return res;
+}
+
+/*!
+ * Searches a solution by sampling before PLA. The model is instantiated at numberOfSamples quasi-random points (see
+ * haltonPoints) of the region of epsilon, only the samples within epsilon of the initial instantiation are kept, and the
+ * samples are checked numerically on numberOfThreads threads in the order of their distance to the initial instantiation.
+ * As soon as a sample satisfies the formulae, the samples further away are skipped. PLA then certifies a small box around
+ * the closest satisfying sample: a tenth of the region of epsilon, which is made four times smaller up to three times if
+ * it is not AllSat. A sample, whose box cannot be certified, is not a solution, then the search continues with PLA.
+ *
+ * @param model - The parametric model.
+ * @param formulae - The formulae, a sample has to satisfy all of them.
+ * @param region_string - The initial instantiation in form of a region.
+ * @param epsilon - The initial value given by the user.
+ * @param options - The options of the run.
+ * @param outcome - If given, the found instantiation and its distance are stored there.
+ *
+ * @return 1 if a box around a satisfying sample is certified, 9 otherwise.
+ */
+int sampleSearch(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model, std::vector<std::shared_ptr<const storm::logic::Formula>> formulae, std::string region_string, double epsilon, Options const& options, PlaOutcome* outcome = nullptr){
+    typedef storm::utility::ModelInstantiator<storm::models::sparse::Dtmc<storm::RationalFunction>, storm::models::sparse::Dtmc<double>> Instantiator;
+    auto modelParameters = storm::models::sparse::getProbabilityParameters(*model);
+    auto rewParameters = storm::models::sparse::getRewardParameters(*model);
+    modelParameters.insert(rewParameters.begin(), rewParameters.end());
+    ParameterSpace space(modelParameters);
+    Instantiation initial = space.parseBox(region_string).upper;
+    Metric metric = buildMetric(space, options);
+    //! The samples are only taken from the parameter space (see build_parSpace), outside the model is not stochastic
+    std::vector<double> bound = calc_bound(epsilon, metric, space.size());
+    Box region;
+    for(size_t i = 0; i < space.size(); i++){
+        region.lower.push_back(std::max(0.0, initial[i] - bound[i]));
+        region.upper.push_back(std::min(1.0, initial[i] + bound[i]));
+    }
+    std::cout << "Sampling on: "<< space.toString(region) <<std::endl;
+
+    storm::utility::Stopwatch samplingWatch(true);
+    //! The bounds of the region are rounded up, so its corners may be further away than epsilon
+    std::vector<Instantiation> samples;
+    std::vector<double> distances;
+    for(auto const& sample : haltonPoints(region, options.numberOfSamples)){
+        double distance = metric.distance(initial, sample);
+        if(distance <= epsilon){
+            samples.push_back(sample);
+            distances.push_back(distance);
+        }
+    }
+    std::vector<size_t> order(samples.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&distances](size_t a, size_t b){
+        return distances[a] < distances[b];
+    });
+
+    //! The rank of the closest satisfying sample so far, samples of a higher rank are skipped
+    std::atomic<size_t> closest(samples.size());
+    std::atomic<uint64_t> checked(0);
+    uint_fast64_t initialState = *model->getInitialStates().begin();
+    std::vector<size_t> ranks(samples.size());
+    std::iota(ranks.begin(), ranks.end(), 0);
+    WorkStealingPool<size_t> pool(options.numberOfThreads);
+    std::vector<std::unique_ptr<Instantiator>> instantiators(pool.getNumberOfThreads());
+    pool.run(ranks, [&](size_t worker, size_t& rank, WorkStealingPool<size_t>::Spawn const&){
+        if(rank > closest || budgetExhausted(options)){
+            return;
+        }
+        Instantiation const& sample = samples[order[rank]];
+        storm::Environment env;
+        std::unique_ptr<storm::modelchecker::SparseDtmcPrctlModelChecker<storm::models::sparse::Dtmc<double>>> checker;
+        {
+            //! The instantiation evaluates the rational functions, see specificationMutex
+            std::lock_guard<std::mutex> lock(specificationMutex);
+            if(!instantiators[worker]){
+                instantiators[worker].reset(new Instantiator(*model));
+            }
+            storm::utility::parametric::Valuation<storm::RationalFunction> valuation;
+            for(size_t i = 0; i < space.size(); i++){
+                valuation[space.getVariable(i)] = storm::utility::convertNumber<storm::RationalFunctionCoefficient>(sample[i]);
+            }
+            checker.reset(new storm::modelchecker::SparseDtmcPrctlModelChecker<storm::models::sparse::Dtmc<double>>(instantiators[worker]->instantiate(valuation)));
+        }
+        checked++;
+        for(auto const& formula : formulae){
+            auto result = checker->check(env, storm::modelchecker::CheckTask<storm::logic::Formula, double>(*formula, true));
+            if(!result->asExplicitQualitativeCheckResult()[initialState]){
+                return;
+            }
+        }
+        size_t current = closest;
+        while(rank < current && !closest.compare_exchange_weak(current, rank)){
+        }
+    });
+    samplingWatch.stop();
+    STORM_PRINT("Time for sampling: " << samplingWatch << ".\n\n");
+    runReport.addPhase("sampling", std::to_string(checked) + " samples", samplingWatch.getTimeInMilliseconds());
+    if(closest == samples.size()){
+        std::cout << "Sampling: no satisfying sample among " << checked << " samples." << std::endl;
+        return 9;
+    }
+    Instantiation const& sample = samples[order[closest]];
+    std::cout << "Sampling: " << checked << " samples checked, the closest satisfying sample is at distance " << distances[order[closest]] << "." << std::endl;
+
+    //! Certify a small box around the sample within the region, the sample itself is only checked numerically
+    storm::utility::Stopwatch PLAwatch(true);
+    Box box;
+    bool certified = false;
+    try{
+        storm::Environment env;
+        auto checker = acquireChecker(model, formulae, MonotonicityVector());
+        double fraction = 0.1;
+        for(int attempt = 0; attempt < 4 && !certified; attempt++, fraction /= 4){
+            box = Box();
+            for(size_t i = 0; i < space.size(); i++){
+                box.lower.push_back(std::max(region.lower[i], sample[i] - fraction * bound[i]));
+                box.upper.push_back(std::min(region.upper[i], sample[i] + fraction * bound[i]));
+            }
+            certified = checker->analyzeRegion(env, space.toExactRegion(box), storm::modelchecker::RegionResultHypothesis::Unknown) == storm::modelchecker::RegionResult::AllSat;
+        }
+        releaseChecker(model, formulae, MonotonicityVector(), std::move(checker));
+    }catch(storm::exceptions::InvalidArgumentException const&){
+        certified = false;
+    }
+    PLAwatch.stop();
+    STORM_PRINT("Time for PLA: " << PLAwatch << ".\n\n");
+    runReport.addPhase("pla", "certification", PLAwatch.getTimeInMilliseconds());
+    if(!certified){
+        std::cout << "Sampling: the box around the sample is not AllSat, continuing with PLA." << std::endl;
+        return 9;
+    }
+    std::cout << "The box around the sample is AllSat." << std::endl;
+
+    //! In the certified box the closest point to the initial instantiation is taken
+    Instantiation newInst = getInstantiationFromBox(box, initial);
+    double distanceMin = metric.distance(initial, newInst);
+    std::cout << distanceMin << " The " << metric.getName() << " - distance between the original and new instantiation:" <<std::endl;
+
+    reportInstantiation(space, newInst, distanceMin, false, outcome, box);
+    return 1;
+}
+
+/*!
+ * Estimates how much every parameter can change the formulae within the region of PLA: the partial derivative of the
+ * probability at the initial instantiation, computed by central finite differences on the instantiated model, times the
+ * change of the bounds of the parameter. The largest value over the formulae is taken.
+ *
+ * @param model - The model.
+ * @param formulae - The formulae, only probability formulae are supported.
+ * @param space - The parameters.
+ * @param initial - The initial instantiation.
+ * @param bound - The change of the bounds of every parameter, calculated in calc_bound.
+ *
+ * @return The sensitivity of every parameter, empty if a formula is not supported.
+ */
+std::vector<double> estimateSensitivity(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model, std::vector<std::shared_ptr<const storm::logic::Formula>> const& formulae, ParameterSpace const& space, Instantiation const& initial, std::vector<double> const& bound){
+    typedef storm::utility::parametric::Valuation<storm::RationalFunction> Valuation;
+    std::vector<std::shared_ptr<const storm::logic::Formula>> quantitative;
+    for(auto const& formula : formulae){
+        if(!formula->isProbabilityOperatorFormula()){
+            return std::vector<double>();
+        }
+        quantitative.push_back(std::make_shared<storm::logic::ProbabilityOperatorFormula>(formula->asOperatorFormula().getSubformula().asSharedPointer()));
+    }
+    uint_fast64_t initialState = *model->getInitialStates().begin();
+
+    //! The instantiation evaluates the rational functions, see specificationMutex
+    std::lock_guard<std::mutex> lock(specificationMutex);
+    storm::utility::ModelInstantiator<storm::models::sparse::Dtmc<storm::RationalFunction>, storm::models::sparse::Dtmc<double>> instantiator(*model);
+    storm::Environment env;
+    auto probabilities = [&](Instantiation const& point){
+        Valuation valuation;
+        for(size_t i = 0; i < space.size(); i++){
+            valuation[space.getVariable(i)] = storm::utility::convertNumber<storm::RationalFunctionCoefficient>(point[i]);
+        }
+        storm::modelchecker::SparseDtmcPrctlModelChecker<storm::models::sparse::Dtmc<double>> checker(instantiator.instantiate(valuation));
+        std::vector<double> res;
+        for(auto const& formula : quantitative){
+            auto result = checker.check(env, storm::modelchecker::CheckTask<storm::logic::Formula, double>(*formula, true));
+            res.push_back(result->asExplicitQuantitativeCheckResult<double>()[initialState]);
+        }
+        return res;
+    };
+
+    std::vector<double> res(space.size(), 0);
+    double const step = 1e-4;
+    for(size_t i = 0; i < space.size(); i++){
+        //! At the border of [0,1] the difference is taken on one side only
+        Instantiation lower = initial;
+        Instantiation upper = initial;
+        lower[i] = std::max(0.0, initial[i] - step);
+        upper[i] = std::min(1.0, initial[i] + step);
+        std::vector<double> lowerValues = probabilities(lower);
+        std::vector<double> upperValues = probabilities(upper);
+        for(size_t f = 0; f < quantitative.size(); f++){
+            double derivative = (upperValues[f] - lowerValues[f]) / (upper[i] - lower[i]);
+            //! A non finite difference never freezes the parameter
+            res[i] = std::isfinite(derivative) ? std::max(res[i], std::abs(derivative) * bound[i]) : std::numeric_limits<double>::infinity();
+        }
+    }
+    return res;
+}
+
+/*!
+ * Substitutes the frozen parameters of the model by their initial values.
+ *
+ * @param model - The model.
+ * @param space - The parameters.
+ * @param frozen - For every parameter, if it is frozen.
+ * @param initial - The initial instantiation.
+ *
+ * @return The model in the remaining parameters.
+ */
+std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> freezeParameters(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model, ParameterSpace const& space, std::vector<bool> const& frozen, Instantiation const& initial){
+    storm::utility::parametric::Valuation<storm::RationalFunction> valuation;
+    for(size_t i = 0; i < space.size(); i++){
+        if(frozen[i]){
+            valuation[space.getVariable(i)] = storm::utility::convertNumber<storm::RationalFunctionCoefficient>(initial[i]);
+        }
+    }
+    auto const& matrix = model->getTransitionMatrix();
+    //! The substituted functions are added to the polynomial cache of carl, see specificationMutex
+    std::lock_guard<std::mutex> lock(specificationMutex);
+    storm::storage::SparseMatrixBuilder<storm::RationalFunction> builder(matrix.getRowCount(), matrix.getColumnCount(), matrix.getEntryCount(), true, false);
+    for(uint_fast64_t state = 0; state < matrix.getRowCount(); state++){
+        for(auto const& entry : matrix.getRow(state)){
+            builder.addNextValue(state, entry.getColumn(), storm::utility::parametric::substitute(entry.getValue(), valuation));
+        }
+    }
+    //! The reward models are kept, parameters of the rewards are never frozen
+    return std::make_shared<storm::models::sparse::Dtmc<storm::RationalFunction>>(builder.build(), model->getStateLabeling(), model->getRewardModels());
+}
+
+/*!
+ * Runs PLA and increases epsilon till a feasible solution is found, up to 5 times (ensures termination), or searches
+ * epsilon, if epsilonTolerance is set.
+ *
+ * @param model - The parametric model.
+ * @param formulae - The formulae, a solution has to satisfy all of them.
+ * @param region_string - The initial instantiation in form of a region.
+ * @param epsilon - The initial value given by the user.
+ * @param options - The options of the run, the time budget is already started.
+ * @param outcome - If given, the found instantiation and its distance are stored there.
+ *
+ * @return 1 if a solution was found, 9 if none was found and 23 if none exists.
+ */
+int repeatPla(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model, std::vector<std::shared_ptr<const storm::logic::Formula>> formulae, std::string region_string, double epsilon, Options const& options, PlaOutcome* outcome = nullptr){
+    if(options.epsilonTolerance >= 0){
+        return epsilonSearch(model, formulae, region_string, epsilon, options, outcome);
+    }
+
+    //! Keeps the partition between the retries, if the incremental option is set
+    PreviousPartition partition;
+    PreviousPartition* previous = options.incremental ? &partition : nullptr;
+
+    int res = pla(model, formulae, region_string, epsilon, options, false, previous, outcome);
+    int counter = 1;
+
+    //! Repeat till a feasible solution is found for epsilon, up to 5 times(ensures termination)
+    while(res == 9 && counter <= 5){
+        if(budgetExhausted(options)){
+            std::cout << "The time budget is used up, epsilon is not increased anymore." << std::endl;
+            if(outcome != nullptr){
+                outcome->interrupted = true;
+            }
+            break;
+        }
+        if(counter == 2 && options.faster == true) {
+            int temp = pla(model, formulae, region_string, epsilon + 0.1 * counter, options, true);
+            if (temp == 23) {
+                return 23;
+            }
+            counter++;
+        }else {
+            res = pla(model, formulae, region_string, epsilon + 0.1 * counter, options, false, previous, outcome);
+            counter++;
+        }
+    }
+    return res;
+}
+
+/*!
+ * Freezes the parameters, whose sensitivity (see estimateSensitivity) is below the threshold, at their initial values
+ * and searches a solution in the remaining parameters. The most sensitive parameter is never frozen. A solution keeps
+ * the initial values of the frozen parameters, so its distance is the same in the whole parameter space.
+ *
+ * @param model - The parametric model.
+ * @param formulae - The formulae.
+ * @param region_string - The initial instantiation in form of a region.
+ * @param epsilon - The initial value given by the user.
+ * @param options - The options of the run, the time budget is already started.
+ * @param outcome - If given, the found instantiation with all parameters and its distance are stored there.
+ *
+ * @return 1 if a solution was found, 9 or 23 if none was found with the frozen parameters, 0 if no parameter was frozen.
+ */
+int frozenSearch(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model, std::vector<std::shared_ptr<const storm::logic::Formula>> formulae, std::string region_string, double epsilon, Options const& options, PlaOutcome* outcome = nullptr){
+    auto modelParameters = storm::models::sparse::getProbabilityParameters(*model);
+    auto rewParameters = storm::models::sparse::getRewardParameters(*model);
+    modelParameters.insert(rewParameters.begin(), rewParameters.end());
+    ParameterSpace space(modelParameters);
+    Instantiation initial = space.parseBox(region_string).upper;
+
+    storm::utility::Stopwatch sensitivityWatch(true);
+    std::vector<double> sensitivity = estimateSensitivity(model, formulae, space, initial, calc_bound(epsilon, buildMetric(space, options), space.size()));
+    sensitivityWatch.stop();
+    STORM_PRINT("Time for the sensitivity analysis: " << sensitivityWatch << ".\n\n");
+    runReport.addPhase("sensitivity", "", sensitivityWatch.getTimeInMilliseconds());
+    if(sensitivity.empty()){
+        std::cout << "The sensitivity is only estimated for probability formulae, no parameter is frozen." << std::endl;
+        return 0;
+    }
+
+    size_t mostSensitive = std::max_element(sensitivity.begin(), sensitivity.end()) - sensitivity.begin();
+    std::vector<bool> frozen(space.size(), false);
+    size_t numberOfFrozen = 0;
+    std::cout << "Sensitivity:";
+    for(size_t i = 0; i < space.size(); i++){
+        frozen[i] = sensitivity[i] < options.sensitivity && i != mostSensitive && rewParameters.count(space.getVariable(i)) == 0;
+        numberOfFrozen += frozen[i] ? 1 : 0;
+        std::cout << " " << space.getName(i) << " " << sensitivity[i] << (frozen[i] ? " (frozen)" : "");
+    }
+    std::cout << std::endl;
+    if(!options.batchRow){
+        runReport.setResult("frozenParameters", std::to_string(numberOfFrozen));
+    }
+    if(numberOfFrozen == 0){
+        return 0;
+    }
+    std::cout << "Frozen " << numberOfFrozen << " of " << space.size() << " parameters at their initial values." << std::endl;
+
+    auto reduced = freezeParameters(model, space, frozen, initial);
+    ParameterSpace reducedSpace(storm::models::sparse::getAllParameters(*reduced));
+    Box reducedInitial;
+    for(size_t i = 0; i < reducedSpace.size(); i++){
+        reducedInitial.lower.push_back(initial[space.getIndex(reducedSpace.getName(i))]);
+        reducedInitial.upper.push_back(initial[space.getIndex(reducedSpace.getName(i))]);
+    }
+    //! The weights of the frozen parameters are left out
+    Options reducedOptions = options;
+    if(!options.metricWeights.empty()){
+        std::vector<std::string> entries, kept;
+        boost::split(entries, options.metricWeights, boost::is_any_of(","));
+        for(auto const& entry : entries){
+            std::string parameter = entry.substr(0, entry.find("="));
+            parameter.erase(std::remove_if(parameter.begin(), parameter.end(), ::isspace), parameter.end());
+            if(!frozen[space.getIndex(parameter)]){
+                kept.push_back(entry);
+            }
+        }
+        reducedOptions.metricWeights = boost::join(kept, ",");
+    }
+    //! The verdicts depend on the values of the frozen parameters, which are not part of the key of the region cache
+    reducedOptions.cacheDirectory = "";
+
+    int res = repeatPla(reduced, formulae, reducedSpace.toString(reducedInitial), epsilon, reducedOptions, outcome);
+    if(res != 1){
+        std::cout << "No solution found with the frozen parameters, all parameters are unfrozen." << std::endl;
+        return res;
+    }
+    for(size_t i = 0; i < space.size(); i++){
+        if(frozen[i]){
+            std::cout << space.getName(i) << "= " << initial[i] << std::endl;
+        }
+    }
+    if(outcome != nullptr){
+        std::map<std::string, double> values(outcome->instantiation.begin(), outcome->instantiation.end());
+        Instantiation inst = initial;
+        for(size_t i = 0; i < space.size(); i++){
+            auto it = values.find(space.getName(i));
+            if(it != values.end()){
+                inst[i] = it->second;
+            }
+        }
+        outcome->instantiation = space.toNamed(inst);
+    }
+    return 1;
+}
+
+/*!
+ * Runs PLA and increases epsilon till a feasible solution is found, up to 5 times (ensures termination).
+ *
+ * @param model - The parametric model.
+ * @param formulae - The formulae, a solution has to satisfy all of them.
+ * @param region_string - The initial instantiation in form of a region.
+ * @param epsilon - The initial value given by the user.
+ * @param options - The options of the run, a copy, because the time budget is started in it.
+ * @param outcome - If given, the found instantiation and its distance are stored there.
+ *
+ * @return 1 if a solution was found, 9 if none was found and 23 if none exists.
+ */
+int minimalChange(std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model, std::vector<std::shared_ptr<const storm::logic::Formula>> formulae, std::string region_string, double epsilon, Options options, PlaOutcome* outcome = nullptr){
+    //! The solution function mode does not need epsilon
+    if(options.solutionFunction){
+        int res = solutionFunctionSearch(model, formulae, region_string, options, outcome);
+        if(outcome != nullptr){
+            outcome->status = res;
+        }
+        return res;
+    }
+
+    //! With a time budget, no new PLA attempt is started after the budget is used up
+    startTimeBudget(options);
+
+    //! The search in the reduced parameter space falls back to all parameters, if it finds no solution
+    int res = 0;
+    if(options.numberOfSamples > 0){
+        res = sampleSearch(model, formulae, region_string, epsilon, options, outcome);
+    }
+    if(res != 1 && options.sensitivity >= 0){
+        res = frozenSearch(model, formulae, region_string, epsilon, options, outcome);
+    }
+    if(res != 1 && !(res != 0 && budgetExhausted(options))){
+        if(outcome != nullptr){
+            *outcome = PlaOutcome();
+        }
+        res = repeatPla(model, formulae, region_string, epsilon, options, outcome);
+    }
+    if(outcome != nullptr){
+        outcome->status = res;
+    }
+    return res;
+}
+
+/*!
+ * Adds the outcome of the run to the run report.
+ *
+ * @param outcome - The outcome of minimalChange.
+ */
+void recordOutcome(PlaOutcome const& outcome){
+    runReport.setResult("status", RunReport::quote(outcome.status == 1 ? "found" : (outcome.status == 23 ? "infeasible" : "not_found")));
+    runReport.setResult("interrupted", outcome.interrupted ? "true" : "false");
+    if(outcome.status != 1){
+        return;
+    }
+    std::ostringstream distance, gap, instantiation;
+    distance << std::setprecision(10) << outcome.distance;
+    gap << std::setprecision(10) << outcome.gap;
+    instantiation << std::setprecision(10) << "{";
+    for(size_t i = 0; i < outcome.instantiation.size(); i++){
+        instantiation << (i == 0 ? "" : ", ") << RunReport::quote(outcome.instantiation[i].first) << ": " << outcome.instantiation[i].second;
+    }
+    instantiation << "}";
+    runReport.setResult("region", RunReport::quote(outcome.centerSat ? "CenterSat" : "AllSat"));
+    runReport.setResult("distance", distance.str());
+    if(outcome.gap >= 0){
+        runReport.setResult("gap", gap.str());
+    }
+    runReport.setResult("instantiation", instantiation.str());
+}
+
+/*!
+ * Parses epsilon, given on the command line, in a query or in a batch row.
+ *
+ * @param str - The string.
+ *
+ * @return epsilon, throws if it is negative.
+ */
+double parseEpsilon(std::string const& str){
+    double epsilon = std::stod(str);
+    if(!(epsilon >= 0)){
+        throw std::invalid_argument("Epsilon must not be negative: " + str);
+    }
+    return epsilon;
+}
+
+/*!
+ * Sets the options from the user input.
+ *
+ * @param options - The options, only the given ones are changed.
+ * @param argc - The number of arguments given by the user.
+ * @param argv - The arguments given by the user.
+ */
+void setOptions(Options& options, int argc ,char *argv[]){
+     for(int i = 5; i < argc; i++) {
+         //! Every option is followed by its value, also the flags
+         if(i + 1 >= argc){
+             if(std::string(argv[i]).compare(0, 2, "--") == 0){
+                 throw std::invalid_argument("The option " + std::string(argv[i]) + " has no value.");
+             }
+             break;
+         }
+         if (std::string(argv[i]) == "--numberOfRandom") {
+             options.numberOfRandom = std::stoi(std::string(argv[i+1]) );
+             std::cout << "Number of random instantiations: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--depthLimit") {
+             options.depthLimit = std::stoi(std::string(argv[i+1]));
+             std::cout << "Depth limit: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--refThreshold") {
+             options.refThreshold = std::stod(std::string(argv[i+1]));
+             if(options.refThreshold <= 0 || options.refThreshold >= 1){
+                 std::cout << "Please, choose a suitable value for refThreshold in (0,1)." << endl;
+             }
+             std::cout << "Refinement threshold: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--faster") {
+             options.faster = true;
+             std::cout << "Faster computation: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--threads") {
+             options.numberOfThreads = std::stoul(std::string(argv[i+1]));
+             std::cout << "Number of threads: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--selection") {
+             if(std::string(argv[i+1]) != "exact" && std::string(argv[i+1]) != "random"){
+                 throw std::invalid_argument("The selection must be exact or random, not " + std::string(argv[i+1]) + ".");
+             }
+             options.exactSelection = std::string(argv[i+1]) == "exact";
+             std::cout << "Selection: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--includeCenterSat") {
+             options.includeCenterSat = true;
+             std::cout << "Include CenterSat regions: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--bestFirst") {
+             options.bestFirstTolerance = std::stod(std::string(argv[i+1]));
+             std::cout << "Best-first refinement with tolerance: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--binaryCache") {
+             options.binaryCache = true;
+             std::cout << "Binary model cache: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--preprocessing") {
+             std::string value = argv[i+1];
+             std::vector<std::string> steps;
+             boost::split(steps, value, boost::is_any_of(","), boost::token_compress_on);
+             options.preprocessingSteps.clear();
+             for(auto& step : steps){
+                 boost::trim(step);
+                 if(step.empty()){
+                     continue;
+                 }
+                 if(step != "simplify" && step != "bisimulation" && step != "elimination"){
+                     throw std::invalid_argument("The preprocessing steps must be simplify, bisimulation or elimination, not " + step + ".");
+                 }
+                 options.preprocessingSteps.push_back(step);
+             }
+             options.preprocessing = std::string(argv[i+1]);
+             std::cout << "Preprocessing: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--solutionFunction") {
+             options.solutionFunction = true;
+             std::cout << "Solution function: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--metric") {
+             options.metricNorm = std::string(argv[i+1]);
+             std::cout << "Metric: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--weights") {
+             options.metricWeights = std::string(argv[i+1]);
+             std::cout << "Weights of the parameters: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--report") {
+             options.reportPath = std::string(argv[i+1]);
+             std::cout << "Run report: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--timeBudget") {
+             options.timeBudget = std::stod(std::string(argv[i+1]));
+             std::cout << "Time budget in seconds: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--epsilonSearch") {
+             options.epsilonTolerance = std::stod(std::string(argv[i+1]));
+             std::cout << "Epsilon search with tolerance: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--speculative") {
+             options.speculativeAttempts = std::stoul(std::string(argv[i+1]));
+             std::cout << "Speculative epsilon attempts: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--monotonicity") {
+             options.monotonicity = true;
+             std::cout << "Monotonicity: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--sensitivity") {
+             options.sensitivity = std::stod(std::string(argv[i+1]));
+             std::cout << "Sensitivity threshold: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--parseThreads") {
+             options.parseThreads = std::stoul(std::string(argv[i+1]));
+             std::cout << "Threads for parsing the model: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--keepViolated") {
+             options.keepViolated = true;
+             std::cout << "Keep AllViolated regions: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--regionMemory") {
+             options.regionMemory = std::stod(std::string(argv[i+1]));
+             std::cout << "Memory for the regions in MB: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--certify") {
+             options.certify = true;
+             std::cout << "Exact certification: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--cache") {
+             options.cacheDirectory = std::string(argv[i+1]);
+             std::cout << "Region cache: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--regionCacheSize") {
+             options.regionCacheSize = std::stod(std::string(argv[i+1]));
+             std::cout << "Size of the region cache in MB: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--samples") {
+             options.numberOfSamples = std::stoul(std::string(argv[i+1]));
+             std::cout << "Number of samples: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--constants") {
+             options.constants = std::string(argv[i+1]);
+             std::cout << "Constants: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--symbolic") {
+             options.symbolic = true;
+             std::cout << "Symbolic model construction: " << argv[i + 1] << endl;
+         } else if (std::string(argv[i])  == "--incremental") {
+             options.incremental = true;
+             std::cout << "Incremental computation: " << argv[i + 1] << endl;
+         }else{
+             if(i%2 == 1){
+                 std::cout << "There is no such option: " << argv[i] << endl;
+             }
+         }
+     }
+     //! The best-first refinement (see refineAndSelect) is sequential and keeps its regions in its own queue
+     if(options.bestFirstTolerance >= 0 || (options.timeBudget >= 0 && options.numberOfThreads <= 1)){
+         std::vector<std::string> ignored;
+         if(options.numberOfThreads > 1){
+             ignored.push_back("threads");
+         }
+         if(options.incremental){
+             ignored.push_back("incremental");
+         }
+         if(!options.cacheDirectory.empty()){
+             ignored.push_back("cache");
+         }
+         if(options.regionMemory > 0){
+             ignored.push_back("regionMemory");
+         }
+         if(!ignored.empty()){
+             std::cout << "Warning: the best-first refinement ignores the options " << boost::join(ignored, ", ") << "." << endl;
+         }
+     }
+ }
+
+/*!
+ * Sets the options from arguments given as strings, see setOptions.
+ *
+ * @param options - The options, only the given ones are changed.
+ * @param arguments - The arguments, the options start at the sixth argument like on the command line.
+ */
+void setOptions(Options& options, std::vector<std::string> arguments){
+    std::vector<char*> argv;
+    for(auto& argument : arguments){
+        argv.push_back(&argument[0]);
+    }
+    //! Terminated like the arguments of main
+    argv.push_back(nullptr);
+    setOptions(options, argv.size() - 1, argv.data());
+}
+
+/*!
+ * Appends the options given in a single string, e.g. "--depthLimit 5", to the arguments.
+ *
+ * @param arguments - The arguments.
+ * @param str - The options separated by spaces.
+ */
+void appendOptions(std::vector<std::string>& arguments, std::string const& str){
+    std::vector<std::string> options;
+    boost::split(options, str, boost::is_any_of(" "), boost::token_compress_on);
+    for(auto const& option : options){
+        if(!option.empty()){
+            arguments.push_back(option);
+        }
+    }
+}
+
+/*!
+ * Checks if the arguments are correct to start the algorithm.
+ *
+ * @param options - Set to the options given by the user.
+ * @param argc - The number of arguments given by the user.
+ * @param argv - The arguments given by the user.
+ */
+void check_argv(Options& options, int argc ,char *argv[]){
+    std::ifstream test(argv[1]);
+    if (!test){
+        std::cout << argv[1]  << "is not a valid path/file." << endl;
+        throw std::invalid_argument("");
+    }
+    std::cout << "Region: " << argv[3]  << endl;
+    std::cout << "Epsilon: " << argv[4]  << endl;
+    if(argc > 5){
+        setOptions(options, argc, argv);
+    }
+}
+
+/*!
+ * @param path_to_model - The path to the model file.
+ *
+ * @return true if the file is a PRISM file (.pm or .prism), otherwise it is a drn file.
+ */
+bool isPrismFile(std::string const& path_to_model){
+    return boost::ends_with(path_to_model, ".pm") || boost::ends_with(path_to_model, ".prism");
+}
+
+/*!
+ * Builds the model from a PRISM file, restricted to the formulae. Only the labels and reward models of the formulae
+ * are built and for a single formula the states, where it is decided (e.g. the target states of a reachability
+ * formula), are made absorbing, so their successors are not explored. The property driven simplification then
+ * collapses the states, that cannot influence the value of the formula (cone of influence).
+ * The undefined constants of the program, that are not given in constants, are the parameters.
+ *
+ * @param path_to_model - The path to the PRISM file.
+ * @param property_string - The property or the path to the property file, parsed for the program.
+ * @param options - The options of the run, with constants and symbolic.
+ * @param formulae - Set to the formulae, for a single formula the simplified one.
+ *
+ * @return The model.
+ */
+std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> buildPrismModel(std::string const& path_to_model, std::string const& property_string, Options const& options, std::vector<std::shared_ptr<const storm::logic::Formula>>& formulae){
+    storm::storage::SymbolicModelDescription description(storm::parser::PrismParser::parse(path_to_model));
+    description = description.preprocess(options.constants);
+    STORM_LOG_THROW(description.asPrismProgram().getModelType() == storm::prism::Program::ModelType::DTMC, storm::exceptions::InvalidArgumentException, "Only DTMCs are supported, " << path_to_model << " is of another model type.");
+    formulae = storm::api::extractFormulasFromProperties(storm::api::parsePropertiesForPrismProgram(property_string, description.asPrismProgram()));
+
+    std::shared_ptr<storm::models::sparse::Model<storm::RationalFunction>> built;
+    if(options.symbolic){
+        //! Sylvan is the library of decision diagrams, that supports rational functions
+        auto symbolicModel = storm::api::buildSymbolicModel<storm::dd::DdType::Sylvan, storm::RationalFunction>(description, formulae);
+        built = storm::api::transformSymbolicToSparseModel(symbolicModel);
+    }else{
+        built = storm::api::buildSparseModel<storm::RationalFunction>(description, formulae);
+    }
+    auto model = built->template as<storm::models::sparse::Dtmc<storm::RationalFunction>>();
+    std::cout << "Built: " << model->getNumberOfStates() << " states, " << model->getNumberOfTransitions() << " transitions." << std::endl;
+
+    if(formulae.size() == 1){
+        storm::transformer::SparseParametricDtmcSimplifier<storm::models::sparse::Dtmc<storm::RationalFunction>> simplifier(*model);
+        if(simplifier.simplify(*formulae[0])){
+            model = simplifier.getSimplifiedModel();
+            formulae[0] = simplifier.getSimplifiedFormula();
+        }
+        std::cout << "Restricted to the property: " << model->getNumberOfStates() << " states, " << model->getNumberOfTransitions() << " transitions." << std::endl;
+    }
+    return model;
+}
+
+/*!
+ * Builds the model from a drn file: from the binary cache, if binaryCache is set, with parseDrnModel on parseThreads
+ * threads, if it is positive, and with the parser of storm otherwise or if parseDrnModel does not support the file.
+ *
+ * @param path_to_model - The path to the drn file.
+ * @param options - The options of the run.
+ *
+ * @return The model.
+ */
+std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> buildModel(std::string const& path_to_model, Options const& options){
+    if(options.binaryCache){
+        return buildModelWithBinaryCache(path_to_model, options.parseThreads);
+    }
+    std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model;
+    if(options.parseThreads > 0){
+        model = parseDrnModel(path_to_model, options.parseThreads);
+    }
+    if(!model){
+        model = storm::api::buildExplicitDRNModel<storm::RationalFunction>(path_to_model)->template as<storm::models::sparse::Dtmc<storm::RationalFunction>>();
+    }
+    return model;
+}
+
+/*!
+ * A parsed model, together with the modification time of its file to notice when it changes.
+ */
+struct CachedModel {
+    std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model;
+    time_t modified;
+    //! The formulae, if the model was preprocessed for them
+    std::vector<std::shared_ptr<const storm::logic::Formula>> formulae;
+};
+
+typedef LruCache<std::string, CachedModel> ModelCache;
+typedef LruCache<std::string, std::vector<std::shared_ptr<const storm::logic::Formula>>> FormulaCache;
+
+/*!
+ * Gets the model from the cache or parses it, if it is not cached or the file changed since.
+ *
+ * @param path_to_model - The path to the drn file.
+ * @param models - The cache of the parsed models.
+ * @param options - The options of the query.
+ *
+ * @return The parsed model.
+ */
+std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> loadModel(std::string const& path_to_model, ModelCache& models, Options const& options){
+    struct stat info;
+    if(stat(path_to_model.c_str(), &info) != 0){
+        throw std::invalid_argument(path_to_model + " is not a valid path/file.");
+    }
+    CachedModel* cached = models.get(path_to_model);
+    if(cached != nullptr && cached->modified == info.st_mtime){
+        return cached->model;
+    }
+
+    storm::utility::Stopwatch modelParsingWatch(true);
+    auto model = buildModel(path_to_model, options);
+    modelParsingWatch.stop();
+    STORM_PRINT("Time for model input parsing: " << modelParsingWatch << ".\n\n");
+    runReport.addPhase("parse", path_to_model, modelParsingWatch.getTimeInMilliseconds());
+
+    models.put(path_to_model, CachedModel{model, info.st_mtime, {}});
+    return model;
+}
+
+/*!
+ * Gets the formulae from the cache or parses them.
+ *
+ * @param property_string - The property or the path to the property file.
+ * @param formulae - The cache of the parsed formulae.
+ *
+ * @return The parsed formulae.
+ */
+std::vector<std::shared_ptr<const storm::logic::Formula>> loadFormulae(std::string const& property_string, FormulaCache& formulae){
+    auto cached = formulae.get(property_string);
+    if(cached != nullptr){
+        return *cached;
+    }
+    return formulae.put(property_string, storm::api::extractFormulasFromProperties(storm::api::parseProperties(property_string)));
+}
+
+/*!
+ * Gets the model of a PRISM file from the cache or builds and preprocesses it. The model is built for the property,
+ * so the property, the constants and the preprocessing are part of the key.
+ *
+ * @param path_to_model - The path to the PRISM file.
+ * @param property_string - The property or the path to the property file.
+ * @param models - The cache of the built models.
+ * @param model - Set to the model.
+ * @param formulae - Set to the formulae.
+ * @param options - The options of the query.
+ */
+void loadPrismModel(std::string const& path_to_model, std::string const& property_string, ModelCache& models, std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>>& model, std::vector<std::shared_ptr<const storm::logic::Formula>>& formulae, Options const& options){
+    struct stat info;
+    if(stat(path_to_model.c_str(), &info) != 0){
+        throw std::invalid_argument(path_to_model + " is not a valid path/file.");
+    }
+    std::string key = path_to_model + "\t" + property_string + "\t" + options.constants + "\t" + (options.symbolic ? "symbolic" : "sparse") + "\t" + options.preprocessing;
+    CachedModel* cached = models.get(key);
+    if(cached != nullptr && cached->modified == info.st_mtime){
+        model = cached->model;
+        formulae = cached->formulae;
+        return;
+    }
+
+    storm::utility::Stopwatch modelParsingWatch(true);
+    model = buildPrismModel(path_to_model, property_string, options, formulae);
+    modelParsingWatch.stop();
+    STORM_PRINT("Time for model input parsing: " << modelParsingWatch << ".\n\n");
+    runReport.addPhase("parse", path_to_model, modelParsingWatch.getTimeInMilliseconds());
+    preprocessModel(model, formulae, options);
+    models.put(key, CachedModel{model, info.st_mtime, formulae});
+}
+
+/*!
+ * Gets the model and the formulae and preprocesses them, the preprocessed model is cached as well.
+ *
+ * @param path_to_model - The path to the drn file.
+ * @param property_string - The property or the path to the property file.
+ * @param models - The cache of the parsed and preprocessed models.
+ * @param formulae - The cache of the parsed formulae.
+ * @param model - Set to the model.
+ * @param formulaeOfQuery - Set to the formulae.
+ * @param options - The options of the query.
+ */
+void loadPreprocessedModel(std::string const& path_to_model, std::string const& property_string, ModelCache& models, FormulaCache& formulae, std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>>& model, std::vector<std::shared_ptr<const storm::logic::Formula>>& formulaeOfQuery, Options const& options){
+    if(isPrismFile(path_to_model)){
+        loadPrismModel(path_to_model, property_string, models, model, formulaeOfQuery, options);
+        return;
+    }
+    model = loadModel(path_to_model, models, options);
+    formulaeOfQuery = loadFormulae(property_string, formulae);
+    if(options.preprocessing.empty()){
+        return;
+    }
+    time_t modified = models.get(path_to_model)->modified;
+    std::string key = path_to_model + "\t" + property_string + "\t" + options.preprocessing;
+    CachedModel* cached = models.get(key);
+    if(cached != nullptr && cached->modified == modified){
+        model = cached->model;
+        formulaeOfQuery = cached->formulae;
+        return;
+    }
+    preprocessModel(model, formulaeOfQuery, options);
+    models.put(key, CachedModel{model, modified, formulaeOfQuery});
+}
+
+/*!
+ * Formats the outcome of a query as a result record.
+ *
+ * @param outcome - The outcome of minimalChange.
+ * @param milliseconds - The wall time of the query.
+ *
+ * @return The record, the fields status, region, distance, instantiation and time separated by tabs.
+ */
+std::string resultRecord(PlaOutcome const& outcome, double milliseconds){
+    std::ostringstream record;
+    record << "result\t";
+    if(outcome.status == 1){
+        record << "found\t" << (outcome.centerSat ? "CenterSat" : "AllSat") << "\t" << outcome.distance << "\t";
+        for(size_t i = 0; i < outcome.instantiation.size(); i++){
+            record << (i == 0 ? "" : ",") << outcome.instantiation[i].first << "=" << outcome.instantiation[i].second;
+        }
+    }else if(outcome.status == 23){
+        record << "infeasible\t\t\t";
+    }else{
+        record << "not_found\t\t\t";
+    }
+    record << "\t" << milliseconds << "ms";
+    return record.str();
+}
+
+/*!
+ * The checksum of a model file, cached with the time of its last change, so the service reads the file only again when
+ * it changes (see fileChecksum).
+ */
+struct CachedChecksum {
+    time_t modified;
+    uint64_t checksum;
+};
+
+std::mutex checksumMutex;
+std::map<std::string, CachedChecksum> checksumCache;
+
+/*!
+ * @param path - The path to the model file.
+ *
+ * @return The checksum of the file, computed only if the file changed since the last call.
+ */
+uint64_t cachedFileChecksum(std::string const& path){
+    struct stat info;
+    if(stat(path.c_str(), &info) != 0){
+        throw std::invalid_argument(path + " is not a valid path/file.");
+    }
+    std::lock_guard<std::mutex> lock(checksumMutex);
+    auto it = checksumCache.find(path);
+    if(it != checksumCache.end() && it->second.modified == info.st_mtime){
+        return it->second.checksum;
+    }
+    uint64_t checksum = fileChecksum(path);
+    checksumCache[path] = CachedChecksum{info.st_mtime, checksum};
+    return checksum;
+}
+
+/*!
+ * Handles a single query of the service.
+ *
+ * @param line - The query, the fields model, property, region and epsilon separated by tabs, followed by the options, e.g. "--depthLimit 5".
+ * @param models - The cache of the parsed models.
+ * @param formulae - The cache of the parsed formulae.
+ *
+ * @return The result record, a single line starting with "result" or "error".
+ */
+std::string handleQuery(std::string const& line, ModelCache& models, FormulaCache& formulae){
+    std::vector<std::string> fields;
+    boost::split(fields, line, boost::is_any_of("\t"));
+    if(fields.size() < 4){
+        return "error\tThe following fields are obligatory: model, property, region's string and epsilon!";
+    }
+
+    //! The options are given the same way as on the command line, so they are set with setOptions
+    std::vector<std::string> arguments = {"serve", fields[0], fields[1], fields[2], fields[3]};
+    for(size_t i = 4; i < fields.size(); i++){
+        appendOptions(arguments, fields[i]);
+    }
+
+    try{
+        Options options;
+        setOptions(options, arguments);
+        runReport.clear();
+
+        storm::utility::Stopwatch queryWatch(true);
+        std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model;
+        std::vector<std::shared_ptr<const storm::logic::Formula>> formulaeOfQuery;
+        loadPreprocessedModel(fields[0], fields[1], models, formulae, model, formulaeOfQuery, options);
+        if(!options.cacheDirectory.empty()){
+            options.modelChecksum = cachedFileChecksum(fields[0]);
+        }
+
+        PlaOutcome outcome;
+        minimalChange(model, formulaeOfQuery, fields[2], parseEpsilon(fields[3]), options, &outcome);
+        queryWatch.stop();
+        if(!options.reportPath.empty()){
+            recordOutcome(outcome);
+            runReport.write(options.reportPath, queryWatch.getTimeInMilliseconds());
+        }
+        return resultRecord(outcome, queryWatch.getTimeInMilliseconds());
+    }catch(std::exception const& e){
+        return std::string("error\t") + e.what();
+    }
+}
+
+/*!
+ * Writes the whole string to a file descriptor.
+ *
+ * @param fd - The file descriptor.
+ * @param str - The string to write.
+ */
+void writeAll(int fd, std::string const& str){
+    size_t written = 0;
+    while(written < str.size()){
+        ssize_t n = write(fd, str.data() + written, str.size() - written);
+        if(n <= 0){
+            return;
+        }
+        written += n;
+    }
+}
+
+/*!
+ * Long-running mode, that answers queries and keeps the parsed models and formulae in a cache.
+ * Every query is a single line and is answered with a single line, see handleQuery.
+ * The line "shutdown" stops the service.
+ *
+ * @param socketPath - The path of the unix socket to listen on, if empty the queries are read from stdin and the records
+ * are written to stdout, while the output of the queries goes to stderr.
+ * @param cacheSize - How many parsed models are kept.
+ *
+ * @return The exit code.
+ */
+int serve(std::string const& socketPath, size_t cacheSize){
+    ModelCache models(cacheSize);
+    FormulaCache formulae(16 * cacheSize);
+    //! The checkers and the monotonicity analyses of a model removed from the cache would keep it in memory
+    models.setEvictionHandler([](CachedModel& cached){
+        conjunctionCheckers.drop(cached.model);
+        liftingCheckers.drop(cached.model);
+        dropMonotonicity(cached.model);
+    });
+
+    if(socketPath.empty()){
+        //! stdout only carries the records, everything printed while answering a query is redirected to stderr
+        std::cout.flush();
+        int records = dup(STDOUT_FILENO);
+        if(records < 0 || dup2(STDERR_FILENO, STDOUT_FILENO) < 0){
+            throw std::runtime_error("Could not separate the records from the output.");
+        }
+        std::string line;
+        while(std::getline(std::cin, line)){
+            if(line == "shutdown"){
+                break;
+            }
+            if(!std::all_of(line.begin(), line.end(), ::isspace)){
+                std::string record = handleQuery(line, models, formulae);
+                std::cout.flush();
+                writeAll(records, record + "\n");
+            }
+        }
+        close(records);
+        return 0;
+    }
+
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if(socketPath.size() >= sizeof(address.sun_path)){
+        throw std::invalid_argument("The path of the socket is too long: " + socketPath);
+    }
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socketPath.c_str());
+    if(server < 0 || bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(server, 16) != 0){
+        throw std::invalid_argument("Could not listen on the socket " + socketPath);
+    }
+    std::cout << "Listening on " << socketPath << std::endl;
+
+    bool running = true;
+    while(running){
+        int client = accept(server, nullptr, nullptr);
+        if(client < 0){
+            continue;
+        }
+        std::string buffer;
+        char chunk[4096];
+        ssize_t n;
+        while(running && (n = read(client, chunk, sizeof(chunk))) > 0){
+            buffer.append(chunk, n);
+            std::string::size_type positionOfNewline;
+            while(running && (positionOfNewline = buffer.find('\n')) != std::string::npos){
+                std::string line = buffer.substr(0, positionOfNewline);
+                buffer.erase(0, positionOfNewline + 1);
+                if(!line.empty() && line.back() == '\r'){
+                    line.pop_back();
+                }
+                if(line == "shutdown"){
+                    running = false;
+                }else if(!std::all_of(line.begin(), line.end(), ::isspace)){
+                    writeAll(client, handleQuery(line, models, formulae) + "\n");
+                }
+            }
+        }
+        close(client);
+    }
+    close(server);
+    unlink(socketPath.c_str());
+    return 0;
+}
+
+/*!
+ * Batch mode, that answers the queries of a batch file (see readBatchFile) against a single model. The model is parsed
+ * and preprocessed once with the options given on the command line and then shared read-only by the workers, each of
+ * which answers one row at a time. The options of a row are set on top of the options of the command line, only the
+ * options for the model (binaryCache, preprocessing) and the report are taken from the command line alone.
+ * The result records (see handleQuery) are written in the order of the rows, each preceded by the number of the row.
+ *
+ * @param argc - The number of arguments given by the user.
+ * @param argv - The arguments: --batch model property rows [--workers n] [--output path] [options].
+ *
+ * @return The exit code.
+ */
+int batch(int argc, char *argv[]){
+    if(argc < 5){
+        throw std::invalid_argument("The batch mode needs a model, a property and a batch file: --batch model property rows [--workers n] [--output path] [options]");
+    }
+    std::string path_to_model = argv[2];
+    std::string property_string = argv[3];
+    std::string rowsPath = argv[4];
+    std::string outputPath = rowsPath + ".results.tsv";
+    size_t numberOfWorkers = std::max(std::thread::hardware_concurrency(), 1u);
+
+    //! The options for all rows start at the sixth argument like on the command line
+    std::vector<std::string> arguments = {"batch", path_to_model, property_string, "", ""};
+    for(int i = 5; i < argc; i++){
+        if(std::string(argv[i]) == "--workers" && i + 1 < argc){
+            numberOfWorkers = std::stoul(std::string(argv[i + 1]));
+            std::cout << "Number of workers: " << argv[i + 1] << endl;
+            i++;
+        }else if(std::string(argv[i]) == "--output" && i + 1 < argc){
+            outputPath = argv[i + 1];
+            std::cout << "Results: " << argv[i + 1] << endl;
+            i++;
+        }else{
+            arguments.push_back(argv[i]);
+        }
+    }
+    Options batchOptions;
+    setOptions(batchOptions, arguments);
+    batchOptions.concurrent = numberOfWorkers > 1;
+    batchOptions.batchRow = true;
+    std::vector<BatchRow> rows = readBatchFile(rowsPath);
+
+    storm::utility::Stopwatch totalTimer(true);
+    //! The parsed and the preprocessed model
+    ModelCache models(2);
+    FormulaCache formulae(1);
+    std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model;
+    std::vector<std::shared_ptr<const storm::logic::Formula>> formulaeOfBatch;
+    loadPreprocessedModel(path_to_model, property_string, models, formulae, model, formulaeOfBatch, batchOptions);
+    if(!batchOptions.cacheDirectory.empty()){
+        batchOptions.modelChecksum = fileChecksum(path_to_model);
+    }
+
+    std::vector<std::string> records(rows.size());
+    std::vector<size_t> indices(rows.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    WorkStealingPool<size_t> pool(std::min(numberOfWorkers, std::max<size_t>(rows.size(), 1)));
+    pool.run(indices, [&](size_t, size_t& index, WorkStealingPool<size_t>::Spawn const&){
+        BatchRow const& row = rows[index];
+        if(!row.error.empty()){
+            records[index] = "error\t" + row.error;
+            return;
+        }
+        try{
+            Options options = batchOptions;
+            std::vector<std::string> rowArguments = {"batch", path_to_model, property_string, row.region, row.epsilon};
+            appendOptions(rowArguments, row.options);
+            setOptions(options, rowArguments);
+            //! The model is shared by all rows, so the options for the model cannot be changed per row
+            options.binaryCache = batchOptions.binaryCache;
+            options.preprocessing = batchOptions.preprocessing;
+            options.preprocessingSteps = batchOptions.preprocessingSteps;
+            options.parseThreads = batchOptions.parseThreads;
+            options.reportPath = batchOptions.reportPath;
+            options.cacheDirectory = batchOptions.cacheDirectory;
+            options.constants = batchOptions.constants;
+            options.symbolic = batchOptions.symbolic;
+            options.regionCacheSize = batchOptions.regionCacheSize;
+
+            storm::utility::Stopwatch rowWatch(true);
+            PlaOutcome outcome;
+            minimalChange(model, formulaeOfBatch, row.region, parseEpsilon(row.epsilon), options, &outcome);
+            rowWatch.stop();
+            records[index] = resultRecord(outcome, rowWatch.getTimeInMilliseconds());
+        }catch(std::exception const& e){
+            records[index] = std::string("error\t") + e.what();
+        }
+    });
+
+    std::ofstream output(outputPath);
+    if(!output){
+        throw std::invalid_argument("Could not write the results " + outputPath);
+    }
+    size_t found = 0;
+    for(size_t i = 0; i < records.size(); i++){
+        output << i + 1 << "\t" << records[i] << "\n";
+        found += records[i].compare(0, 12, "result\tfound") == 0 ? 1 : 0;
+    }
+    totalTimer.stop();
+    std::cout << "Answered " << rows.size() << " rows, " << found << " with a solution, the results are in " << outputPath << "." << endl;
+    STORM_PRINT("Time for the batch: " << totalTimer << ".\n\n");
+    if(!batchOptions.reportPath.empty()){
+        runReport.setResult("rows", std::to_string(rows.size()));
+        runReport.setResult("found", std::to_string(found));
+        runReport.write(batchOptions.reportPath, totalTimer.getTimeInMilliseconds());
+    }
+    return 0;
+}
+
+/*!
+ * argv[1] - file of the model
+ * argv[2] - file of PCTL formula
+ * argv[3] - instantiation in form of a region, e.g. "0.5 <= p <=0.5, 0.5 <= q <=0.5"
+ * argv[4] - epsilon
+ */
+int main(int argc, char *argv[]) {
+    //! Service mode: --serve [socket] [--cacheSize n]
+    if(argc > 1 && std::string(argv[1]) == "--serve"){
+        std::string socketPath;
+        size_t cacheSize = 4;
+        for(int i = 2; i < argc; i++){
+            if(std::string(argv[i]) == "--cacheSize" && i + 1 < argc){
+                cacheSize = std::stoul(std::string(argv[++i]));
+            }else{
+                socketPath = argv[i];
+            }
+        }
+        storm::utility::setUp();
+        storm::settings::initializeParsSettings("Storm-pars", "storm-pars");
+        int exitCode = serve(socketPath, cacheSize);
+        storm::utility::cleanUp();
+        return exitCode;
+    }
+
+    //! Batch mode: --batch model property rows [--workers n] [--output path] [options]
+    if(argc > 1 && std::string(argv[1]) == "--batch"){
+        storm::utility::setUp();
+        storm::settings::initializeParsSettings("Storm-pars", "storm-pars");
+        int exitCode = batch(argc, argv);
+        storm::utility::cleanUp();
+        return exitCode;
+    }
+
+    //! Check number of arguments
+    if(argc < 5){
+        throw std::invalid_argument("The following arguments are obligatory: model, pctl, region's string and epsilon!");
+    }
+    //! Check if the arguments are correct
+    Options options;
+    check_argv(options, argc, argv);
+
+    //! Init loggers.
+    storm::utility::setUp();
+    //! Init settings.
+    storm::settings::initializeParsSettings("Storm-pars", "storm-pars");
+
+    storm::utility::Stopwatch totalTimer(true);
 
     storm::utility::Stopwatch modelParsingWatch(true);
 
     std::string path_to_model = argv[1];
     std::string property_string = argv[2];
 
-    //drn Parser
-    auto model = storm::api::buildExplicitDRNModel<storm::RationalFunction>(argv[1])->template as<storm::models::sparse::Dtmc<storm::RationalFunction>>();
-    std::string formulasString = argv[2];
-    auto formulae = storm::api::extractFormulasFromProperties(storm::api::parseProperties(formulasString));
-
-    //prism Parser
-    /*
-    auto program = storm::parser::PrismParser::parse(path_to_model);
-    assert(program.getModelType() == storm::prism::Program::ModelType::DTMC);
-    auto properties = storm::api::parsePropertiesForPrismProgram(property_string, program);
-    std::vector<std::shared_ptr<const storm::logic::Formula>> formulae = storm::api::extractFormulasFromProperties(properties);
-    std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model = storm::api::buildSparseModel<storm::RationalFunction>(program, formulae)->template as<storm::models::sparse::Dtmc<storm::RationalFunction>>();
-     */
+    std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalFunction>> model;
+    std::vector<std::shared_ptr<const storm::logic::Formula>> formulae;
+    if(isPrismFile(path_to_model)){
+        //prism Parser
+        model = buildPrismModel(path_to_model, property_string, options, formulae);
+    }else{
+        //drn Parser
+        model = buildModel(path_to_model, options);
+        std::string formulasString = argv[2];
+        formulae = storm::api::extractFormulasFromProperties(storm::api::parseProperties(formulasString));
+    }
     modelParsingWatch.stop();
     STORM_PRINT("Time for model input parsing: " << modelParsingWatch << ".\n\n");
+    runReport.addPhase("parse", path_to_model, modelParsingWatch.getTimeInMilliseconds());
 
-    int res = pla(model, formulae, argv[3], std::stod(argv[4]));
-    int counter = 1;
+    //! The reduced model is used for all PLA calls
+    preprocessModel(model, formulae, options);
+    if(!options.cacheDirectory.empty()){
+        options.modelChecksum = fileChecksum(path_to_model);
+    }
 
-    //! Repeat till a feasible solution is found for epsilon, up to 5 times(ensures termination)
-    while(res == 9 && counter <= 5){
-        if(counter == 2 && faster == true) {
-            int temp = pla(model, formulae, argv[3], std::stod(argv[4]) + 0.1 * counter, true);
-            if (temp == 23) {
-                std::cout << "No feasible solution exists for this property." << endl;
-                return 0;
-            }
-            counter++;
-        }else {
-            res = pla(model, formulae, argv[3], std::stod(argv[4]) + 0.1 * counter);
-            counter++;
+    PlaOutcome outcome;
+    int res = minimalChange(model, formulae, argv[3], parseEpsilon(argv[4]), options, &outcome);
+    recordOutcome(outcome);
+    if(res == 23){
+        std::cout << "No feasible solution exists for this property." << endl;
+        totalTimer.stop();
+        if(!options.reportPath.empty()){
+            runReport.write(options.reportPath, totalTimer.getTimeInMilliseconds());
         }
+        return 0;
     }
     if(res == 9){
         std::cout << "No feasible solution found after increasing epsilon with 0.5 please give different arguments and try again." << argv[3]  << endl;
     }
 
     totalTimer.stop();
+    if(!options.reportPath.empty()){
+        runReport.write(options.reportPath, totalTimer.getTimeInMilliseconds());
+    }
     storm::cli::printTimeAndMemoryStatistics(totalTimer.getTimeInMilliseconds());
 
     //!Clean after ready